@@ -20,99 +20,156 @@ namespace bustub {
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
                                      LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
+    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager), free_list_(pool_size) {
   // we allocate a consecutive memory space for the buffer pool
   pages_ = new Page[pool_size_];
   replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+    free_list_.Push(static_cast<int>(i));
+  }
+
+  prefetch_thread_ = std::thread([this] { PrefetcherLoop(); });
+}
+
+BufferPoolManager::~BufferPoolManager() {
+  {
+    std::scoped_lock lk(prefetch_latch_);
+    prefetch_shutdown_ = true;
+  }
+  prefetch_cv_.notify_one();
+  prefetch_thread_.join();
+  delete[] pages_;
+}
+
+void BufferPoolManager::PrefetchPage(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) return;
+  {
+    std::scoped_lock lk(prefetch_latch_);
+    prefetch_queue_.push_back(page_id);
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManager::PrefetcherLoop() {
+  while (1) {
+    page_id_t pid;
+    {
+      std::unique_lock lk(prefetch_latch_);
+      prefetch_cv_.wait(lk, [&] { return prefetch_shutdown_ || !prefetch_queue_.empty(); });
+      if (prefetch_shutdown_) return;
+      pid = prefetch_queue_.front();
+      prefetch_queue_.pop_front();
+    }
+    {
+      std::scoped_lock shard_latch(ShardOf(pid).latch_);
+      if (ShardOf(pid).table_.Find(pid) != nullptr) continue;
+    }
+    if (FetchPage(pid, AccessType::Scan) != nullptr) UnpinPage(pid, false, AccessType::Scan);
   }
 }
 
-BufferPoolManager::~BufferPoolManager() { delete[] pages_; }
+auto BufferPoolManager::AcquireFrame(frame_id_t *fid) -> bool {
+  if (free_list_.Pop(fid)) return true;
+  if (!replacer_->Evict(fid)) return false;
+  auto page = &pages_[*fid];
+  auto pid = page->GetPageId();
+  BUSTUB_ASSERT(!page->GetPinCount(), "Pin count should be 0.");
+  // Hold the victim's shard latch across writeback and reset so a concurrent
+  // FlushPage can't race against the frame being repurposed.
+  auto &shard = ShardOf(pid);
+  std::scoped_lock shard_latch(shard.latch_);
+  if (page->IsDirty()) disk_manager_->WritePage(pid, page->GetData());
+  page->ResetMemory();
+  auto mapped = shard.table_.Find(pid);
+  if (mapped != nullptr && *mapped == *fid) shard.table_.Erase(pid);
+  return true;
+}
 
 auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
-  std::scoped_lock latch(latch_);
-  Page *page;
   frame_id_t fid;
-  page_id_t pid;
-  if (free_list_.size()) {
-    fid = free_list_.front();
-    free_list_.pop_front();
-  } else if (replacer_->Evict(&fid)) {
-    page = &pages_[fid];
-    pid = page->GetPageId();
-    BUSTUB_ASSERT(!page->GetPinCount(), "Pin count should be 0.");
-    if (page->IsDirty()) disk_manager_->WritePage(pid, page->GetData());
-    page->ResetMemory();
-    page_table_.erase(pid);
-  } else {
-    return nullptr;
+  // Fast path: grab a free frame with one CAS and skip the replacement latch entirely —
+  // a brand-new page id can't race with a concurrent load of the same page.
+  if (!free_list_.Pop(&fid)) {
+    std::scoped_lock latch(latch_);
+    if (!AcquireFrame(&fid)) return nullptr;
   }
-  replacer_->RecordAccess(fid);
-  replacer_->SetEvictable(fid, false);
-  page = &pages_[fid];
-  pid = AllocatePage();
+  replacer_->AccessAndPin(fid);
+  auto page = &pages_[fid];
+  auto pid = AllocatePage();
+  auto &shard = ShardOf(pid);
+  std::scoped_lock shard_latch(shard.latch_);
   page->page_id_ = pid;
   page->is_dirty_ = false;
   page->pin_count_ = 1;
-  page_table_[pid] = fid;
+  shard.table_.Insert(pid, fid);
   *page_id = pid;
   return page;
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
-  std::scoped_lock latch(latch_);
-  Page *page;
-  frame_id_t fid;
-  page_id_t pid;
-  if (page_table_.count(page_id)) {
-    fid = page_table_[page_id];
-  } else {
-    if (free_list_.size()) {
-      fid = free_list_.front();
-      free_list_.pop_front();
-    } else if (replacer_->Evict(&fid)) {
-      page = &pages_[fid];
-      pid = page->GetPageId();
-      BUSTUB_ASSERT(!page->GetPinCount(), "Pin count should be 0.");
-      if (page->IsDirty()) disk_manager_->WritePage(pid, page->GetData());
-      page->ResetMemory();
-      page_table_.erase(pid);
-    } else {
-      return nullptr;
+auto BufferPoolManager::FetchPage(page_id_t page_id, AccessType access_type) -> Page * {
+  auto &shard = ShardOf(page_id);
+  while (1) {
+    {
+      // Hit path: only the shard latch. Pin() fails iff a concurrent
+      // replacement claimed the frame after we read the mapping; the
+      // replacing thread drops the stale entry under the shard latch,
+      // so retrying resolves one way or the other.
+      std::scoped_lock shard_latch(shard.latch_);
+      auto mapped = shard.table_.Find(page_id);
+      if (mapped != nullptr) {
+        auto fid = *mapped;
+        if (!replacer_->Pin(fid, access_type)) continue;
+        pages_[fid].pin_count_++;
+        return &pages_[fid];
+      }
     }
-    page = &pages_[fid];
+    // Miss path: serialize replacement, then re-check — another miss may
+    // have loaded the page while we waited for latch_.
+    std::scoped_lock latch(latch_);
+    {
+      std::scoped_lock shard_latch(shard.latch_);
+      if (shard.table_.Find(page_id) != nullptr) continue;
+    }
+    frame_id_t fid;
+    if (!AcquireFrame(&fid)) return nullptr;
+    auto page = &pages_[fid];
     disk_manager_->ReadPage(page_id, page->GetData());
+    replacer_->AccessAndPin(fid, access_type);
+    std::scoped_lock shard_latch(shard.latch_);
     page->page_id_ = page_id;
     page->is_dirty_ = false;
+    page->pin_count_ = 1;
+    shard.table_.Insert(page_id, fid);
+    return page;
   }
-  replacer_->RecordAccess(fid);
-  replacer_->SetEvictable(fid, false);
-  pages_[fid].pin_count_++;
-  page_table_[page_id] = fid;
-  return &pages_[fid];
 }
 
 auto BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty, [[maybe_unused]] AccessType access_type) -> bool {
-  std::scoped_lock latch(latch_);
-  if (!page_table_.count(page_id)) return false;
-  auto fid = page_table_[page_id];
-  if (!pages_[fid].GetPinCount()) return false;
-  pages_[fid].pin_count_--;
-  if (!pages_[fid].GetPinCount()) {
+  auto &shard = ShardOf(page_id);
+  std::scoped_lock shard_latch(shard.latch_);
+  auto mapped = shard.table_.Find(page_id);
+  if (mapped == nullptr) return false;
+  auto fid = *mapped;
+  // All pin transitions for a resident page happen under its shard latch, so a plain
+  // load-then-decrement is safe; the counter itself is atomic so guards and other
+  // readers can observe it without any pool latch.
+  if (!pages_[fid].pin_count_.load(std::memory_order_relaxed)) return false;
+  auto prev = pages_[fid].pin_count_.fetch_sub(1, std::memory_order_acq_rel);
+  if (prev == 1) {
     replacer_->SetEvictable(fid, true);
   }
-  pages_[fid].is_dirty_ |= is_dirty;
+  if (is_dirty) pages_[fid].is_dirty_.store(true, std::memory_order_release);
   return true;
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  std::scoped_lock latch(latch_);
-  if (!page_table_.count(page_id)) return false;
-  auto fid = page_table_[page_id];
+  auto &shard = ShardOf(page_id);
+  std::scoped_lock shard_latch(shard.latch_);
+  auto mapped = shard.table_.Find(page_id);
+  if (mapped == nullptr) return false;
+  auto fid = *mapped;
   disk_manager_->WritePage(page_id, pages_[fid].GetData());
   pages_[fid].is_dirty_ = false;
   return true;
@@ -120,23 +177,44 @@ auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
 
 void BufferPoolManager::FlushAllPages() {}
 
-auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool { return false; }
+auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
+  auto &shard = ShardOf(page_id);
+  std::scoped_lock shard_latch(shard.latch_);
+  auto mapped = shard.table_.Find(page_id);
+  if (mapped == nullptr) return true;
+  auto fid = *mapped;
+  if (pages_[fid].GetPinCount() != 0) return false;
+  // Same latch order as the FetchPage hit path: shard latch, then replacer.
+  // Remove fails iff a concurrent replacement already evicted this frame: the
+  // evictor owns it now and will drop the stale mapping under our shard latch,
+  // so recycling it here would put one frame in two hands. Either way the page
+  // is unpinned and gone, so the delete itself succeeds.
+  if (replacer_->Remove(fid)) {
+    shard.table_.Erase(page_id);
+    pages_[fid].ResetMemory();
+    pages_[fid].page_id_ = INVALID_PAGE_ID;
+    pages_[fid].is_dirty_ = false;
+    free_list_.Push(fid);
+  }
+  DeallocatePage(page_id);
+  return true;
+}
 
 auto BufferPoolManager::AllocatePage() -> page_id_t { return next_page_id_++; }
 
-auto BufferPoolManager::FetchPageBasic(page_id_t page_id) -> BasicPageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageBasic(page_id_t page_id, AccessType access_type) -> BasicPageGuard {
+  Page *page = FetchPage(page_id, access_type);
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageRead(page_id_t page_id) -> ReadPageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageRead(page_id_t page_id, AccessType access_type) -> ReadPageGuard {
+  Page *page = FetchPage(page_id, access_type);
   page->rwlatch_.RLock();
   return {this, page};
 }
 
-auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard {
-  Page *page = FetchPage(page_id);
+auto BufferPoolManager::FetchPageWrite(page_id_t page_id, AccessType access_type) -> WritePageGuard {
+  Page *page = FetchPage(page_id, access_type);
   page->rwlatch_.WLock();
   return {this, page};
 }
@@ -146,4 +224,11 @@ auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard {
   return {this, page};
 }
 
+auto BufferPoolManager::NewPageWrite(page_id_t *page_id) -> WritePageGuard {
+  Page *page = NewPage(page_id);
+  BUSTUB_ASSERT(page, "Failed to create new page.");
+  page->rwlatch_.WLock();
+  return {this, page};
+}
+
 }  // namespace bustub
@@ -15,72 +15,152 @@
 
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k), less_than_k_heap_(k), equal_to_k_heap_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {
+    node_store_.reserve(num_frames);
+    for (size_t i = 0; i < num_frames; i++) node_store_.emplace_back(i, k);
+    heap_.Reserve(num_frames);
+}
 
 auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
     std::scoped_lock latch(latch_);
     if (!curr_size_) return false;
-    std::shared_ptr<LRUKNode> node;
-    if (less_than_k_heap_.Size()) {
-        node = less_than_k_heap_.Pop();
-    } else if (equal_to_k_heap_.Size()) {
-        node = equal_to_k_heap_.Pop();
+    // Young frames all have +inf backward k-distance, so the head of the young
+    // list (earliest first access) always wins over anything in the heap.
+    LRUKNode *node;
+    if (young_head_ != nullptr) {
+        node = young_head_;
+        YoungUnlink(*node);
     } else {
-        throw bustub::Exception("BUG.");
+        if (!heap_.Size()) throw bustub::Exception("BUG.");
+        node = heap_.Pop();
     }
     *frame_id = node->fid_;
-    node_store_.erase(node->fid_);
+    node->is_evictable_ = false;
+    node->present_ = false;
     curr_size_--;
     return true;
 }
 
-void LRUKReplacer::RecordAccess(frame_id_t frame_id, [[maybe_unused]] AccessType access_type) {
+void LRUKReplacer::RecordAccess(frame_id_t frame_id, AccessType access_type) {
+    std::scoped_lock latch(latch_);
+    BUSTUB_ASSERT(frame_id >= 0 && size_t(frame_id) < replacer_size_, "frame_id out of range.");
+    auto &node = node_store_[frame_id];
+    if (!node.present_) {
+        node.present_ = true;
+        node.head_ = node.count_ = 0;
+        node.is_evictable_ = false;
+        node.i_ = -1;
+    }
+    HistoryRecord(node, access_type);
+    if (!node.is_evictable_) return;
+    if (node.i_ >= 0) {
+        // Already in the heap: the new access changed its span, re-sift in place.
+        heap_.Update(node.i_);
+    } else if (node.count_ >= k_) {
+        // Crossed its k-th access: graduate from the young list into the heap.
+        YoungUnlink(node);
+        heap_.Push(&node);
+    }
+    // Still young: its first-access timestamp is unchanged, so its list slot is too.
+}
+
+auto LRUKReplacer::Pin(frame_id_t frame_id, AccessType access_type) -> bool {
     std::scoped_lock latch(latch_);
     BUSTUB_ASSERT(frame_id >= 0 && size_t(frame_id) < replacer_size_, "frame_id out of range.");
-    if (!node_store_.count(frame_id)) node_store_[frame_id] = std::make_shared<LRUKNode>(frame_id);
     auto &node = node_store_[frame_id];
-    auto &history = node->history_;
-    auto less_than_k = history.size() < k_;
-    history.push_back(current_timestamp_++);
-    if (!less_than_k) history.pop_front();
-    if (node->is_evictable_) {
-        less_than_k ?
-            less_than_k_heap_.Remove(node->i_) :
-            equal_to_k_heap_.Remove(node->i_);
-        history.size() < k_ ?
-            less_than_k_heap_.Push(node) :
-            equal_to_k_heap_.Push(node);
+    if (!node.present_) return false;
+    HistoryRecord(node, access_type);
+    if (node.is_evictable_) {
+        Detach(node);
+        node.is_evictable_ = false;
+        curr_size_--;
     }
+    return true;
+}
+
+void LRUKReplacer::AccessAndPin(frame_id_t frame_id, AccessType access_type) {
+    std::scoped_lock latch(latch_);
+    BUSTUB_ASSERT(frame_id >= 0 && size_t(frame_id) < replacer_size_, "frame_id out of range.");
+    auto &node = node_store_[frame_id];
+    if (!node.present_) {
+        node.present_ = true;
+        node.head_ = node.count_ = 0;
+        node.is_evictable_ = false;
+        node.i_ = -1;
+    }
+    HistoryRecord(node, access_type);
+    if (node.is_evictable_) {
+        Detach(node);
+        node.is_evictable_ = false;
+        curr_size_--;
+    }
+}
+
+void LRUKReplacer::HistoryRecord(LRUKNode &node, AccessType access_type) {
+    // Scan accesses are one-shot: stamp the frame once with timestamp 0 so it
+    // sorts as the coldest +inf-distance frame, and never let repeated scan
+    // touches accumulate toward k. This keeps a large sequential scan from
+    // flushing frames with real reuse out of the pool.
+    if (access_type == AccessType::Scan) {
+        if (!node.count_) node.HistoryPush(0);
+        return;
+    }
+    node.HistoryPush(current_timestamp_++);
+    node.sort_key_ = node.HistoryBack() - node.HistoryFront();
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
     std::scoped_lock latch(latch_);
     BUSTUB_ASSERT(frame_id >= 0 && size_t(frame_id) < replacer_size_, "frame_id out of range.");
-    BUSTUB_ASSERT(node_store_.count(frame_id), "frame_id not in the replacer.");
     auto &node = node_store_[frame_id];
-    if (node->is_evictable_ == set_evictable) return;
+    BUSTUB_ASSERT(node.present_, "frame_id not in the replacer.");
+    if (node.is_evictable_ == set_evictable) return;
     if (set_evictable) {
-        node->history_.size() < k_ ? 
-            less_than_k_heap_.Push(node) :
-            equal_to_k_heap_.Push(node);
+        node.count_ < k_ ? YoungPush(node) : heap_.Push(&node);
     } else {
-        node->history_.size() < k_ ?
-            less_than_k_heap_.Remove(node->i_) :
-            equal_to_k_heap_.Remove(node->i_);
+        Detach(node);
     }
     set_evictable ? curr_size_++ : curr_size_--;
-    node->is_evictable_ = set_evictable;
+    node.is_evictable_ = set_evictable;
 }
 
-void LRUKReplacer::Remove(frame_id_t frame_id) {
+auto LRUKReplacer::Remove(frame_id_t frame_id) -> bool {
     std::scoped_lock latch(latch_);
-    if (!node_store_.count(frame_id)) return;
+    if (frame_id < 0 || size_t(frame_id) >= replacer_size_) return false;
     auto &node = node_store_[frame_id];
-    BUSTUB_ASSERT(node->is_evictable_, "can't remove a non-evictable frame.");
-    node->history_.size() < k_ ?
-        less_than_k_heap_.Remove(node->i_) :
-        equal_to_k_heap_.Remove(node->i_);
-    node_store_.erase(frame_id);
+    // Not present means a concurrent Evict already claimed the frame; the
+    // caller must not recycle it.
+    if (!node.present_) return false;
+    BUSTUB_ASSERT(node.is_evictable_, "can't remove a non-evictable frame.");
+    Detach(node);
+    node.is_evictable_ = false;
+    node.present_ = false;
+    curr_size_--;
+    return true;
+}
+
+void LRUKReplacer::YoungPush(LRUKNode &node) {
+    // Walk back from the tail to keep the list sorted by first-access timestamp.
+    // A frame entering with a fresh history carries the newest timestamp, so
+    // this terminates immediately; only re-admissions with retained history
+    // (e.g. scan-stamped frames) walk further.
+    auto ts = node.HistoryFront();
+    auto *after = young_tail_;
+    while (after != nullptr && after->HistoryFront() > ts) after = after->prev_;
+    node.prev_ = after;
+    node.next_ = after != nullptr ? after->next_ : young_head_;
+    (after != nullptr ? after->next_ : young_head_) = &node;
+    (node.next_ != nullptr ? node.next_->prev_ : young_tail_) = &node;
+}
+
+void LRUKReplacer::YoungUnlink(LRUKNode &node) {
+    (node.prev_ != nullptr ? node.prev_->next_ : young_head_) = node.next_;
+    (node.next_ != nullptr ? node.next_->prev_ : young_tail_) = node.prev_;
+    node.prev_ = node.next_ = nullptr;
+}
+
+void LRUKReplacer::Detach(LRUKNode &node) {
+    node.i_ >= 0 ? heap_.Remove(node.i_) : YoungUnlink(node);
 }
 
 auto LRUKReplacer::Size() -> size_t {
@@ -20,8 +20,11 @@ InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *
                                std::unique_ptr<AbstractExecutor> &&child_executor)
     : AbstractExecutor(exec_ctx), plan_(plan), child_plan_(std::move(child_executor)) {
         auto *catalog = exec_ctx_->GetCatalog();
-        auto *tableInfo = catalog->GetTable(plan_->TableOid());
-        indexes_ = catalog->GetTableIndexes(tableInfo->name_);
+        table_info_ = catalog->GetTable(plan_->TableOid());
+        table_heap_ = table_info_->table_.get();
+        for (auto *indexInfo : catalog->GetTableIndexes(table_info_->name_)) {
+            indexes_.push_back({indexInfo->index_.get(), &indexInfo->key_schema_, &indexInfo->index_->GetKeyAttrs()});
+        }
     }
 
 void InsertExecutor::Init() {
@@ -31,17 +34,23 @@ void InsertExecutor::Init() {
 
 auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     if (done_) return false;
-    auto *catalog = exec_ctx_->GetCatalog();
-    auto *tableInfo = catalog->GetTable(plan_->TableOid());
-    auto &tableHeap = tableInfo->table_;
+    auto *lock_mgr = exec_ctx_->GetLockManager();
+    auto *txn = exec_ctx_->GetTransaction();
     auto n = 0;
-    for(;child_plan_->Next(tuple, rid);n++) {
-        tableHeap->InsertTuple(TupleMeta{}, *tuple, exec_ctx_->GetLockManager(), exec_ctx_->GetTransaction(), tableInfo->oid_);
-        for (auto itr = indexes_.begin(); itr != indexes_.end(); itr++) {
-            auto indexInfo = *itr;
-            auto key = tuple->KeyFromTuple(tableInfo->schema_, indexInfo->key_schema_, indexInfo->index_->GetKeyAttrs());
-            indexInfo->index_->InsertEntry(key, *rid, exec_ctx_->GetTransaction());
+    std::vector<Tuple> batch;
+    batch.reserve(BATCH_SIZE);
+    while (true) {
+        batch.clear();
+        while (batch.size() < BATCH_SIZE && child_plan_->Next(tuple, rid)) batch.push_back(*tuple);
+        if (batch.empty()) break;
+        auto rids = table_heap_->InsertTuples(TupleMeta{}, batch, lock_mgr, txn, table_info_->oid_);
+        for (size_t i = 0; i < rids.size(); i++) {
+            for (auto &index : indexes_) {
+                auto key = batch[i].KeyFromTuple(table_info_->schema_, *index.key_schema_, *index.key_attrs_);
+                index.index_->InsertEntry(key, rids[i], txn);
+            }
         }
+        n += rids.size();
     }
     *tuple = Tuple({Value(TypeId::INTEGER, n)}, &plan_->OutputSchema());
     done_ = true;
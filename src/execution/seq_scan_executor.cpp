@@ -11,26 +11,39 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/seq_scan_executor.h"
+#include "storage/page/table_page.h"
 
 namespace bustub {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx), plan_(plan) {}
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx), plan_(plan), table_info_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())) {}
 
 void SeqScanExecutor::Init() {
-    auto *catalog = exec_ctx_->GetCatalog();
-    auto *tableInfo = catalog->GetTable(plan_->GetTableOid());
-    auto &tableHeap = tableInfo->table_;
-    itr_ = std::make_unique<TableIterator>(tableHeap->MakeIterator());
+    itr_ = std::make_unique<TableIterator>(table_info_->table_->MakeIterator(AccessType::Scan));
+    bpm_ = exec_ctx_->GetBufferPoolManager();
+    prefetched_from_page_ = INVALID_PAGE_ID;
 }
 
 auto SeqScanExecutor::Next(Tuple *tuple, RID *rid) -> bool {
     if (itr_->IsEnd()) return false;
+    auto pid = itr_->GetRID().GetPageId();
+    if (pid != prefetched_from_page_) {
+        // First tuple on a new heap page: queue its successor so the disk read
+        // overlaps with processing the tuples on this page. The heap links its
+        // pages in a list, so the successor is only known from this page's header.
+        prefetched_from_page_ = pid;
+        auto guard = bpm_->FetchPageBasic(pid, AccessType::Scan);
+        bpm_->PrefetchPage(guard.As<TablePage>()->GetNextPageId());
+    }
     while(1) {
         auto res = itr_->GetTuple();
         ++(*itr_);
         if (res.first.is_deleted_) continue;
         *tuple = res.second;
         *rid = res.second.GetRid();
+        // Warm the cache line of the tuple the next Next() will copy out; page-boundary
+        // crossings are covered by the page-level prefetch above.
+        if (auto *next_addr = itr_->PeekNextTupleAddress()) __builtin_prefetch(next_addr, 0, 0);
         break;
     }
     return true;
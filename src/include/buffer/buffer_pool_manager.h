@@ -12,10 +12,14 @@
 
 #pragma once
 
-#include <list>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/lru_k_replacer.h"
 #include "common/config.h"
@@ -26,6 +30,177 @@
 
 namespace bustub {
 
+/**
+ * A fixed-capacity lock-free MPMC queue of frame ids (Vyukov's bounded queue), used for the
+ * buffer pool free list so grabbing a free frame is one CAS instead of a pool-latch round trip.
+ * Capacity is rounded up to a power of two.
+ */
+class FreeFrameQueue {
+ public:
+  explicit FreeFrameQueue(size_t capacity) {
+    size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    mask_ = cap - 1;
+    cells_ = std::make_unique<Cell[]>(cap);
+    for (size_t i = 0; i < cap; i++) cells_[i].sequence_.store(i, std::memory_order_relaxed);
+  }
+
+  /** @return false if the queue is full */
+  auto Push(frame_id_t fid) -> bool {
+    Cell *cell;
+    auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      auto seq = cell->sequence_.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (dif == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value_ = fid;
+    cell->sequence_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** @return false if the queue is empty */
+  auto Pop(frame_id_t *fid) -> bool {
+    Cell *cell;
+    auto pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true) {
+      cell = &cells_[pos & mask_];
+      auto seq = cell->sequence_.load(std::memory_order_acquire);
+      auto dif = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (dif == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (dif < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    *fid = cell->value_;
+    cell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence_;
+    frame_id_t value_;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+};
+
+/**
+ * An open-addressed page_id -> frame_id hash table with linear probing, used for the page-table
+ * shards. A lookup probes one contiguous bucket run instead of chasing std::unordered_map's
+ * per-node heap allocations. Empty and erased buckets are marked with negative page-id sentinels,
+ * which is safe because valid page ids are non-negative.
+ */
+class PageTable {
+ public:
+  PageTable() : buckets_(INITIAL_BUCKETS, Bucket{EMPTY, 0}) {}
+
+  /** Pull the home bucket of pid into cache ahead of a lookup. Latch-free and purely
+   * advisory: the address may be stale if the table grows concurrently, which at worst
+   * prefetches a dead line. */
+  void PrefetchBucket(page_id_t pid) const {
+    __builtin_prefetch(&buckets_[Hash(pid) & (buckets_.size() - 1)]);
+  }
+
+  /** @return pointer to the frame id mapped to pid, or nullptr if pid is absent */
+  auto Find(page_id_t pid) -> frame_id_t * {
+    auto mask = buckets_.size() - 1;
+    for (auto i = Hash(pid) & mask;; i = (i + 1) & mask) {
+      auto &bucket = buckets_[i];
+      if (bucket.pid_ == pid) return &bucket.fid_;
+      if (bucket.pid_ == EMPTY) return nullptr;
+    }
+  }
+
+  /** Insert pid -> fid, overwriting any existing mapping. */
+  void Insert(page_id_t pid, frame_id_t fid) {
+    if ((size_ + tombstones_ + 1) * 2 > buckets_.size()) Grow();
+    InsertNoGrow(pid, fid);
+  }
+
+  /** Drop the mapping for pid if present. */
+  void Erase(page_id_t pid) {
+    auto mask = buckets_.size() - 1;
+    for (auto i = Hash(pid) & mask;; i = (i + 1) & mask) {
+      auto &bucket = buckets_[i];
+      if (bucket.pid_ == pid) {
+        bucket.pid_ = TOMBSTONE;
+        size_--;
+        tombstones_++;
+        return;
+      }
+      if (bucket.pid_ == EMPTY) return;
+    }
+  }
+
+ private:
+  static constexpr page_id_t EMPTY = -1;
+  static constexpr page_id_t TOMBSTONE = -2;
+  static constexpr size_t INITIAL_BUCKETS = 64;
+  static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+  struct Bucket {
+    page_id_t pid_;
+    frame_id_t fid_;
+  };
+
+  static auto Hash(page_id_t pid) -> size_t {
+    // Fibonacci hashing: spreads the dense, sequential page ids across buckets.
+    return static_cast<size_t>((static_cast<uint64_t>(pid) * 0x9E3779B97F4A7C15ULL) >> 32);
+  }
+
+  void InsertNoGrow(page_id_t pid, frame_id_t fid) {
+    auto mask = buckets_.size() - 1;
+    auto reuse = NPOS;
+    for (auto i = Hash(pid) & mask;; i = (i + 1) & mask) {
+      auto &bucket = buckets_[i];
+      if (bucket.pid_ == pid) {
+        bucket.fid_ = fid;
+        return;
+      }
+      if (bucket.pid_ == TOMBSTONE && reuse == NPOS) reuse = i;
+      if (bucket.pid_ == EMPTY) {
+        if (reuse != NPOS) {
+          tombstones_--;
+          i = reuse;
+        }
+        buckets_[i] = Bucket{pid, fid};
+        size_++;
+        return;
+      }
+    }
+  }
+
+  void Grow() {
+    std::vector<Bucket> old;
+    old.swap(buckets_);
+    buckets_.assign(old.size() * 2, Bucket{EMPTY, 0});
+    size_ = 0;
+    tombstones_ = 0;
+    for (auto &bucket : old) {
+      if (bucket.pid_ >= 0) InsertNoGrow(bucket.pid_, bucket.fid_);
+    }
+  }
+
+  std::vector<Bucket> buckets_;
+  size_t size_{0};
+  size_t tombstones_{0};
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -85,6 +260,19 @@ class BufferPoolManager {
    */
   auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
 
+  /**
+   * @brief NewPage wrapper returning a write-latched guard.
+   *
+   * WritePageGuard::Drop always releases the write latch, so a guard must
+   * never wrap a page whose latch is not held — releasing an unheld latch is
+   * undefined behavior. Callers that want a WritePageGuard over a fresh page
+   * go through here, mirroring FetchPageWrite.
+   *
+   * @param[out] page_id, the id of the new page
+   * @return WritePageGuard holding a new, write-latched page
+   */
+  auto NewPageWrite(page_id_t *page_id) -> WritePageGuard;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -104,6 +292,29 @@ class BufferPoolManager {
    */
   auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
 
+  /**
+   * @brief Hint that page_id will be read soon.
+   *
+   * Hands the page id to a background worker that reads it into the pool (as a
+   * scan access) if it is not already resident, so the disk read overlaps with
+   * whatever the caller is doing. Purely advisory: no pin is held on behalf of
+   * the caller and the hint may be dropped if the pool is full.
+   *
+   * @param page_id id of the page to read ahead, INVALID_PAGE_ID is ignored
+   */
+  void PrefetchPage(page_id_t page_id);
+
+  /**
+   * @brief Hint that page_id is about to be fetched.
+   *
+   * Prefetches the page-table bucket the upcoming lookup will probe, without taking the
+   * shard latch. Issued a little ahead of FetchPage*, it overlaps the bucket's cache miss
+   * with whatever the caller still does — typically acquiring the shard latch.
+   *
+   * @param page_id id of the page about to be fetched
+   */
+  void PrefetchLookup(page_id_t page_id) { ShardOf(page_id).table_.PrefetchBucket(page_id); }
+
   /**
    * TODO(P1): Add implementation
    *
@@ -117,9 +328,9 @@ class BufferPoolManager {
    * @param page_id, the id of the page to fetch
    * @return PageGuard holding the fetched page
    */
-  auto FetchPageBasic(page_id_t page_id) -> BasicPageGuard;
-  auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
-  auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
+  auto FetchPageBasic(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> BasicPageGuard;
+  auto FetchPageRead(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> ReadPageGuard;
+  auto FetchPageWrite(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> WritePageGuard;
 
   /**
    * TODO(P1): Add implementation
@@ -173,6 +384,15 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
+  /** Number of shards the page table is split into. Page ids hash to a shard by modulo. */
+  static constexpr size_t PAGE_TABLE_SHARDS = 16;
+
+  /** One slice of the page table with its own latch, so lookups on different pages don't serialize. */
+  struct PageTableShard {
+    std::mutex latch_;
+    PageTable table_;
+  };
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** The next page id to be allocated  */
@@ -184,15 +404,38 @@ class BufferPoolManager {
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Sharded page table for keeping track of buffer pool pages. */
+  PageTableShard shards_[PAGE_TABLE_SHARDS];
   /** Replacer to find unpinned pages for replacement. */
   std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** Lock-free queue of free frames that don't have any pages on them. */
+  FreeFrameQueue free_list_;
+  /** Serializes frame eviction and the page-table miss path. Page-table hits never take
+   * this latch; they only take the shard latch of the page they touch. Lock order is
+   * latch_ -> shard latch -> replacer's internal latch; never the other way around. */
   std::mutex latch_;
 
+  /** Readahead worker state: queued page ids, their latch/condvar, and the worker itself. */
+  std::deque<page_id_t> prefetch_queue_;
+  std::mutex prefetch_latch_;
+  std::condition_variable prefetch_cv_;
+  bool prefetch_shutdown_{false};
+  std::thread prefetch_thread_;
+
+  /** @brief Drain prefetch_queue_, reading each non-resident page into the pool. */
+  void PrefetcherLoop();
+
+  /** @brief Return the page table shard that owns page_id. */
+  auto ShardOf(page_id_t page_id) -> PageTableShard & { return shards_[static_cast<size_t>(page_id) % PAGE_TABLE_SHARDS]; }
+
+  /**
+   * @brief Pick a replacement frame from the free list or the replacer, writing back and
+   * unmapping the victim page if there is one. Caller must hold latch_.
+   * @param[out] fid the acquired frame
+   * @return false if every frame is pinned, true otherwise
+   */
+  auto AcquireFrame(frame_id_t *fid) -> bool;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
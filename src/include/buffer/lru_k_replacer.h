@@ -12,10 +12,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <limits>
-#include <list>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
 #include "common/config.h"
@@ -29,18 +28,40 @@ class LRUKNode {
   friend class LRUHeap;
   friend class LRUKReplacer;
   public:
-    LRUKNode(frame_id_t fid) : fid_(fid) {}
+    LRUKNode(frame_id_t fid, size_t k) : fid_(fid), history_(k) {}
   private:
+    // history_ is a fixed-size ring buffer of the last k access timestamps:
+    // oldest at head_, newest at (head_ + count_ - 1) % k. Unlike a
+    // std::list, pushing never touches the allocator and front/back are
+    // plain loads from one contiguous block.
+    void HistoryPush(size_t ts) {
+      auto k = history_.size();
+      history_[(head_ + count_) % k] = ts;
+      count_ < k ? count_++ : head_ = (head_ + 1) % k;
+    }
+    auto HistoryFront() -> size_t { return history_[head_]; }
+    auto HistoryBack() -> size_t { return history_[(head_ + count_ - 1) % history_.size()]; }
     frame_id_t fid_;
-    std::list<size_t> history_;
+    std::vector<size_t> history_;
+    uint32_t head_{0};
+    uint32_t count_{0};
+    bool present_{false};
     bool is_evictable_{false};
+    // Heap sort key (back-front history span), refreshed on every recorded
+    // access so a heap comparison is one load per side instead of two ring
+    // index computations.
+    size_t sort_key_{0};
     int i_{-1};
+    // Intrusive links for the replacer's young list (evictable frames with
+    // fewer than k accesses). Null while the node is not on the list.
+    LRUKNode *prev_{nullptr};
+    LRUKNode *next_{nullptr};
 };
 
 class LRUHeap {
   public:
-    LRUHeap(size_t k) : k_(k) {}
-    void Push(std::shared_ptr<LRUKNode> &node) {
+    LRUHeap() = default;
+    void Push(LRUKNode *node) {
       auto n = heap_.size();
       heap_.push_back(node);
       node->i_ = n;
@@ -55,31 +76,36 @@ class LRUHeap {
       heap_.pop_back();
       down(i);
     }
-    std::shared_ptr<LRUKNode> Pop() {
+    LRUKNode *Pop() {
       auto n = heap_.size();
       BUSTUB_ASSERT(n > 0, "can't pop empty heap.");
       auto node = heap_.front();
       heap_[n-1]->i_ = 0;
-      heap_[0] = std::move(heap_[n-1]);
+      heap_[0] = heap_[n-1];
       heap_.pop_back();
       down(0);
       node->i_ = -1;
       return node;
     }
+    void Reserve(size_t n) {
+      heap_.reserve(n);
+    }
+    void Update(int i) {
+      BUSTUB_ASSERT(i >= 0 && size_t(i) < heap_.size(), "index out of range.");
+      up(i);
+      down(i);
+    }
     size_t Size() {
       return heap_.size();
     }
   private:
-    int compare_(std::shared_ptr<LRUKNode> &lhs, std::shared_ptr<LRUKNode> &rhs) {
+    int compare_(LRUKNode *lhs, LRUKNode *rhs) {
       // >0: lhs > rhs
       // <0: rhs > lhs
-      if (lhs->history_.size() < k_) {
-        BUSTUB_ASSERT(rhs->history_.size() < k_, "BUG.");
-        return rhs->history_.front() - lhs->history_.front();
-      } else {
-        BUSTUB_ASSERT(rhs->history_.size() == k_, "BUG.");
-        return (lhs->history_.back() - lhs->history_.front()) - (rhs->history_.back() - rhs->history_.front());
-      }
+      // Only frames with a full k-entry history live in the heap — evictable
+      // frames with fewer accesses sit on the replacer's young list — so the
+      // comparator is a single comparison of the cached history spans.
+      return lhs->sort_key_ - rhs->sort_key_;
     }
     void up(int i) {
       while (1) {
@@ -104,8 +130,7 @@ class LRUHeap {
         i = j;
       }
     }
-    std::vector<std::shared_ptr<LRUKNode>> heap_;
-    size_t k_;
+    std::vector<LRUKNode *> heap_;
 };
 
 /**
@@ -172,6 +197,34 @@ class LRUKReplacer {
    */
   void RecordAccess(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
 
+  /**
+   * @brief Atomically record an access and mark the frame non-evictable, but only if the
+   * frame is still tracked by the replacer.
+   *
+   * This lets the buffer pool manager re-pin a frame it found in its page table without
+   * holding a pool-wide latch: if a concurrent Evict() already claimed the frame, this
+   * returns false and the caller must treat its page-table entry as stale.
+   *
+   * @param frame_id id of frame being pinned.
+   * @param access_type type of access that caused the pin.
+   * @return true if the frame was tracked and is now non-evictable, false otherwise.
+   */
+  auto Pin(frame_id_t frame_id, AccessType access_type = AccessType::Unknown) -> bool;
+
+  /**
+   * @brief Record an access and mark the frame non-evictable in one latch acquisition,
+   * creating the entry if the frame is not yet tracked.
+   *
+   * Equivalent to RecordAccess followed by SetEvictable(false), which is what the buffer
+   * pool manager wants on every page load — fusing them halves the replacer-latch
+   * round trips on that path. Unlike Pin(), this admits frames the replacer has not
+   * seen yet.
+   *
+   * @param frame_id id of frame being loaded and pinned.
+   * @param access_type type of access that caused the load.
+   */
+  void AccessAndPin(frame_id_t frame_id, AccessType access_type = AccessType::Unknown);
+
   /**
    * TODO(P1): Add implementation
    *
@@ -207,8 +260,10 @@ class LRUKReplacer {
    * If specified frame is not found, directly return from this function.
    *
    * @param frame_id id of frame to be removed
+   * @return true if the frame was present and is now removed, false if it was
+   * not tracked — e.g. a concurrent Evict got to it first
    */
-  void Remove(frame_id_t frame_id);
+  auto Remove(frame_id_t frame_id) -> bool;
 
   /**
    * TODO(P1): Add implementation
@@ -220,13 +275,37 @@ class LRUKReplacer {
   auto Size() -> size_t;
 
  private:
-  std::unordered_map<frame_id_t, std::shared_ptr<LRUKNode>> node_store_;
+  /** @brief Update a node's access history according to the access type. Caller holds latch_. */
+  void HistoryRecord(LRUKNode &node, AccessType access_type);
+
+  /** @brief Put a node on the young list, keeping it sorted by first-access timestamp. */
+  void YoungPush(LRUKNode &node);
+
+  /** @brief Take a node off the young list. */
+  void YoungUnlink(LRUKNode &node);
+
+  /** @brief Detach a node from whichever structure (young list or heap) holds it. */
+  void Detach(LRUKNode &node);
+
+  // Frame ids are dense in [0, replacer_size_), so nodes live in a flat
+  // array indexed by frame id; present_ marks the slots that are in use.
+  // The heap and young list reference these nodes by raw pointer —
+  // node_store_ owns them and never reallocates after construction.
+  std::vector<LRUKNode> node_store_;
   size_t current_timestamp_{0};
   size_t curr_size_{0};
   size_t replacer_size_;
   size_t k_;
-  LRUHeap less_than_k_heap_;
-  LRUHeap equal_to_k_heap_;
+  // Evictable frames with a full k-entry history, ordered by backward k-distance.
+  LRUHeap heap_;
+  // Evictable frames with fewer than k accesses. They all share a +inf backward
+  // k-distance and are evicted before anything in the heap, tie-broken by first
+  // access — an ordered list makes that an O(1) pop instead of a heap sift.
+  // Almost every insertion lands at the tail (a fresh first access carries the
+  // newest timestamp); re-admissions with retained history walk backwards from
+  // the tail to their sorted slot.
+  LRUKNode *young_head_{nullptr};
+  LRUKNode *young_tail_{nullptr};
   std::mutex latch_;
 };
 
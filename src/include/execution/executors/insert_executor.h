@@ -55,10 +55,24 @@ class InsertExecutor : public AbstractExecutor {
   auto GetOutputSchema() const -> const Schema & override { return plan_->OutputSchema(); };
 
  private:
+  /** How many child tuples are buffered per TableHeap::InsertTuples call. */
+  static constexpr size_t BATCH_SIZE = 1024;
+
+  /** Everything needed to maintain one index for an inserted row, flattened out of IndexInfo
+   * so the per-row loop doesn't chase catalog pointers. */
+  struct IndexCache {
+    Index *index_;
+    const Schema *key_schema_;
+    const std::vector<uint32_t> *key_attrs_;
+  };
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
   std::unique_ptr<AbstractExecutor> child_plan_;
-  std::vector<bustub::IndexInfo *> indexes_;
+  /** The destination table, resolved once at construction. */
+  TableInfo *table_info_;
+  TableHeap *table_heap_;
+  std::vector<IndexCache> indexes_;
   bool done_;
 };
 
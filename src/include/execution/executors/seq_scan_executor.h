@@ -50,6 +50,13 @@ class SeqScanExecutor : public AbstractExecutor {
  private:
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** Catalog entry for the scanned table, resolved once in the constructor; Init may run once
+   * per outer row under a nested loop join, so it must not repeat the catalog lookup. */
+  TableInfo *table_info_;
   std::unique_ptr<TableIterator> itr_;
+  /** The buffer pool holding the heap pages, used for readahead. */
+  BufferPoolManager *bpm_{nullptr};
+  /** The heap page whose successor was last handed to the prefetcher. */
+  page_id_t prefetched_from_page_{INVALID_PAGE_ID};
 };
 }  // namespace bustub
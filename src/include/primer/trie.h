@@ -8,6 +8,7 @@
 #include <optional>
 #include <stdexcept>
 #include <string>
+#include <typeinfo>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -43,11 +44,16 @@ class MoveBlocked {
 // A TrieNode is a node in a Trie.
 class TrieNode {
  public:
+  // Children are kept in a flat vector sorted by character instead of a std::map: the branching
+  // factor is small, so every lookup is a binary search over one or two cache lines rather than a
+  // red-black-tree walk with a pointer dereference per level.
+  using ChildrenMap = std::vector<std::pair<char, std::shared_ptr<const TrieNode>>>;
+
   // Create a TrieNode with no children.
   TrieNode() = default;
 
   // Create a TrieNode with some children.
-  explicit TrieNode(std::map<char, std::shared_ptr<const TrieNode>> children) : children_(std::move(children)) {}
+  explicit TrieNode(ChildrenMap children) : children_(std::move(children)) {}
 
   virtual ~TrieNode() = default;
 
@@ -60,40 +66,118 @@ class TrieNode {
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   virtual auto Clone() const -> std::unique_ptr<TrieNode> { return std::make_unique<TrieNode>(children_); }
 
-  // A map of children, where the key is the next character in the key, and the value is the next TrieNode.
-  std::map<char, std::shared_ptr<const TrieNode>> children_;
+  // Return a pointer to the child slot for ch, or nullptr if there is none.
+  auto FindChild(char ch) const -> const std::shared_ptr<const TrieNode> * {
+    auto it = LowerBound(ch);
+    return it != children_.end() && it->first == ch ? &it->second : nullptr;
+  }
+
+  // Insert or overwrite the child for ch, keeping children_ sorted.
+  void SetChild(char ch, std::shared_ptr<const TrieNode> child) {
+    auto it = LowerBound(ch);
+    if (it != children_.end() && it->first == ch) {
+      it->second = std::move(child);
+    } else {
+      children_.emplace(it, ch, std::move(child));
+    }
+  }
+
+  // Drop the child for ch if present.
+  void RemoveChild(char ch) {
+    auto it = LowerBound(ch);
+    if (it != children_.end() && it->first == ch) children_.erase(it);
+  }
+
+  // A sorted vector of children, where the key is the next character in the key, and the value is the next TrieNode.
+  ChildrenMap children_;
 
   // Indicates if the node is the terminal node.
   bool is_value_node_{false};
 
+  // Type of the stored value, set by TrieNodeWithValue<T>'s constructors. Lets Get verify the
+  // value type with one type_info comparison and a static_cast instead of a dynamic_cast.
+  const std::type_info *value_type_{nullptr};
+
   // You can add additional fields and methods here. But in general, you don't need to add extra fields to
   // complete this project.
+
+ private:
+  auto LowerBound(char ch) const -> ChildrenMap::const_iterator {
+    return std::lower_bound(children_.begin(), children_.end(), ch,
+                            [](const ChildrenMap::value_type &entry, char c) { return entry.first < c; });
+  }
+  auto LowerBound(char ch) -> ChildrenMap::iterator {
+    return std::lower_bound(children_.begin(), children_.end(), ch,
+                            [](const ChildrenMap::value_type &entry, char c) { return entry.first < c; });
+  }
 };
 
-// A TrieNodeWithValue is a TrieNode that also has a value of type T associated with it.
+// Small trivially-copyable values are stored inline in the node instead of behind a shared_ptr,
+// saving one allocation per Put and one indirection per Get for the common numeric value types.
 template <class T>
+inline constexpr bool TRIE_VALUE_INLINE = std::is_trivially_copyable_v<T> && sizeof(T) <= 16;
+
+// A TrieNodeWithValue is a TrieNode that also has a value of type T associated with it.
+// The primary template keeps the value behind a shared_ptr; the Inline specialization below
+// stores it directly in the node.
+template <class T, bool Inline = TRIE_VALUE_INLINE<T>>
 class TrieNodeWithValue : public TrieNode {
  public:
   // Create a trie node with no children and a value.
-  explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) { this->is_value_node_ = true; }
+  explicit TrieNodeWithValue(std::shared_ptr<T> value) : value_(std::move(value)) {
+    this->is_value_node_ = true;
+    this->value_type_ = &typeid(T);
+  }
 
   // Create a trie node with children and a value.
-  TrieNodeWithValue(std::map<char, std::shared_ptr<const TrieNode>> children, std::shared_ptr<T> value)
+  TrieNodeWithValue(ChildrenMap children, std::shared_ptr<T> value)
       : TrieNode(std::move(children)), value_(std::move(value)) {
     this->is_value_node_ = true;
+    this->value_type_ = &typeid(T);
   }
 
   // Override the Clone method to also clone the value.
   //
   // Note: if you want to convert `unique_ptr` into `shared_ptr`, you can use `std::shared_ptr<T>(std::move(ptr))`.
   auto Clone() const -> std::unique_ptr<TrieNode> override {
-    return std::make_unique<TrieNodeWithValue<T>>(children_, value_);
+    return std::make_unique<TrieNodeWithValue>(children_, value_);
   }
 
+  // Return a pointer to the stored value.
+  auto ValuePtr() const -> const T * { return value_.get(); }
+
   // The value associated with this trie node.
   std::shared_ptr<T> value_;
 };
 
+// Specialization for small trivially-copyable T: the value lives inline in the node.
+template <class T>
+class TrieNodeWithValue<T, true> : public TrieNode {
+ public:
+  // Create a trie node with no children and a value.
+  explicit TrieNodeWithValue(T value) : value_(value) {
+    this->is_value_node_ = true;
+    this->value_type_ = &typeid(T);
+  }
+
+  // Create a trie node with children and a value.
+  TrieNodeWithValue(ChildrenMap children, T value) : TrieNode(std::move(children)), value_(value) {
+    this->is_value_node_ = true;
+    this->value_type_ = &typeid(T);
+  }
+
+  // Override the Clone method to also clone the value.
+  auto Clone() const -> std::unique_ptr<TrieNode> override {
+    return std::make_unique<TrieNodeWithValue>(children_, value_);
+  }
+
+  // Return a pointer to the stored value.
+  auto ValuePtr() const -> const T * { return &value_; }
+
+  // The value associated with this trie node.
+  T value_;
+};
+
 // A Trie is a data structure that maps strings to values of type T. All operations on a Trie should not
 // modify the trie itself. It should reuse the existing nodes as much as possible, and create new nodes to
 // represent the new trie.
@@ -11,12 +11,16 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <deque>
 #include <iostream>
+#include <new>
 #include <optional>
 #include <queue>
 #include <shared_mutex>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "common/config.h"
@@ -32,6 +36,58 @@ namespace bustub {
 
 struct PrintableBPlusTree;
 
+// An operation descends through at most one page per level, and with a fanout
+// of at least two a depth of 64 already covers more keys than a page id can
+// address. Used to size the inline guard stack below.
+static constexpr size_t BPLUSTREE_MAX_DEPTH = 64;
+
+/**
+ * @brief Fixed-capacity stack with inline storage.
+ *
+ * std::deque heap-allocates a control block plus a node segment on the first
+ * push, which is pure malloc traffic on the Insert/Remove hot path. Elements
+ * live in an in-object buffer instead; Clear() destroys them front to back,
+ * matching the top-down order the old pop_front release loop used.
+ */
+template <typename T, size_t N>
+class InlineStack {
+ public:
+  InlineStack() = default;
+  InlineStack(const InlineStack &) = delete;
+  auto operator=(const InlineStack &) -> InlineStack & = delete;
+  ~InlineStack() { Clear(); }
+
+  auto Size() const -> size_t { return size_; }
+
+  void PushBack(T &&v) {
+    BUSTUB_ASSERT(size_ < N, "InlineStack overflow.");
+    new (&Slot(size_)) T(std::move(v));
+    size_++;
+  }
+
+  auto Back() -> T & {
+    BUSTUB_ASSERT(size_ > 0, "InlineStack is empty.");
+    return Slot(size_ - 1);
+  }
+
+  void PopBack() {
+    BUSTUB_ASSERT(size_ > 0, "InlineStack is empty.");
+    Slot(size_ - 1).~T();
+    size_--;
+  }
+
+  void Clear() {
+    for (size_t i = 0; i < size_; i++) Slot(i).~T();
+    size_ = 0;
+  }
+
+ private:
+  auto Slot(size_t i) -> T & { return *reinterpret_cast<T *>(buf_ + i * sizeof(T)); }
+
+  alignas(T) unsigned char buf_[N * sizeof(T)];
+  size_t size_{0};
+};
+
 /**
  * @brief Definition of the Context class.
  *
@@ -56,6 +112,37 @@ class Context {
   auto IsRootPage(page_id_t page_id) -> bool { return page_id == root_page_id_; }
 };
 
+/** One level of a write descent: the latched page and the child index the
+ * search took out of it (-1 for the leaf, which has no child). Keeping the
+ * index next to its guard replaces the std::deque<int> that used to be
+ * maintained in parallel. */
+struct DescentEntry {
+  WritePageGuard guard_;
+  int child_index_{-1};
+};
+
+/**
+ * @brief Per-operation descent state for Insert/Remove: the write guard on the
+ * header page plus the chain of write-latched pages on the way down. The guard
+ * chain sits in an inline buffer so a descent performs no heap allocation.
+ */
+class DescentContext {
+ public:
+  DescentContext(BufferPoolManager *bpm, page_id_t header_page_id)
+      : header_wg_(bpm->FetchPageWrite(header_page_id)) {}
+
+  auto RootPageId() -> page_id_t { return header_wg_.As<BPlusTreeHeaderPage>()->root_page_id_; }
+
+  // Drop every latch this operation still holds, top-down.
+  void ReleaseAll() {
+    header_wg_.Drop();
+    guards_.Clear();
+  }
+
+  WritePageGuard header_wg_;
+  InlineStack<DescentEntry, BPLUSTREE_MAX_DEPTH> guards_;
+};
+
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 
 // Main class providing the API for the Interactive B+ Tree.
@@ -81,6 +168,12 @@ class BPlusTree {
   // Return the value associated with a given key
   auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn = nullptr) -> bool;
 
+  // Point-look-up a batch of keys at once. (*result)[i] holds the values found for keys[i].
+  // Descending all keys one level at a time lets the search overlap the memory latency of
+  // one key's page with the comparisons of the others.
+  void GetValueBatch(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                     Transaction *txn = nullptr);
+
   // Return the page id of the root node
   auto GetRootPageId() -> page_id_t;
 
@@ -110,7 +203,18 @@ class BPlusTree {
    */
   auto DrawBPlusTree() -> std::string;
 
-  // read data from file and insert one by one
+  // Physically re-cluster the leaf level: copy the leaves in key order into
+  // freshly allocated (hence consecutively numbered) pages so range scans walk
+  // page-id-adjacent pages. Offline only — same contract as InsertFromFile.
+  void Compact();
+
+  // Bottom-up bulk build for an empty tree: sort the pairs, pack the leaves
+  // near capacity in key order, then assemble each internal level from the
+  // one below. Every page is written exactly once and no split ever fires.
+  // Falls back to per-key Insert when the tree already holds data.
+  void BulkLoad(std::vector<std::pair<KeyType, ValueType>> kvs, Transaction *txn = nullptr);
+
+  // read data from file, then bulk load the sorted contents
   void InsertFromFile(const std::string &file_name, Transaction *txn = nullptr);
 
   // read data from file and remove one by one
@@ -118,9 +222,9 @@ class BPlusTree {
 
  private:
   /* Debug Routines for FREE!! */
-  void ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out);
+  void ToGraph(page_id_t page_id, std::ofstream &out);
 
-  void PrintTree(page_id_t page_id, const BPlusTreePage *page);
+  void PrintTree(page_id_t page_id);
 
   /**
    * @brief Convert A B+ tree into a Printable B+ tree
@@ -130,10 +234,25 @@ class BPlusTree {
    */
   auto ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree;
 
+  // Latch-free point lookup validated by page version counters; returns true
+  // only on a validated hit. Misses and conflicts fall back to GetValue's
+  // latched descent.
+  auto GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> bool;
+
+  // Read-latched descent that write-latches only the target leaf; empty when
+  // the caller has to fall back to the fully write-latched descent.
+  auto OptimisticLeafWrite(const KeyType &key) -> std::optional<WritePageGuard>;
+
+  // Rewrite the leaf-parent level's child pointers after Compact relocated
+  // the leaves.
+  void RelinkLeaves(page_id_t pid, const std::unordered_map<page_id_t, page_id_t> &relocated);
+
 
   auto Borrow(WritePageGuard &parent, WritePageGuard &child, int childIndex, bool isChildLeaf) -> bool;
 
-  void Merge(WritePageGuard &parent, WritePageGuard &child, int childIndex, bool isChildLeaf);
+  // Returns the page id of the now-empty page so the caller can delete it
+  // from the buffer pool after dropping its guard.
+  auto Merge(WritePageGuard &parent, WritePageGuard &child, int childIndex, bool isChildLeaf) -> page_id_t;
 
   // member variable
   std::string index_name_;
@@ -143,6 +262,11 @@ class BPlusTree {
   int leaf_max_size_;
   int internal_max_size_;
   page_id_t header_page_id_;
+  // Shadow of the header page's root_page_id_, refreshed under the header
+  // write latch whenever the root changes. Lets IsEmpty, GetRootPageId and
+  // the optimistic descents start from a single atomic load instead of a
+  // buffer-pool fetch plus a latch on the one page every query shares.
+  std::atomic<page_id_t> cached_root_pid_{INVALID_PAGE_ID};
   size_t size_;
   std::mutex latch_;
 };
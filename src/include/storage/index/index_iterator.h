@@ -35,6 +35,14 @@ class IndexIterator {
 
   IndexIterator(page_id_t header_page_id, BufferPoolManager *bpm, const KeyType &key, const KeyComparator &comparator);
 
+  // The iterator keeps its current leaf read-latched and pinned, so it owns
+  // a resource: movable, not copyable, and the destructor releases whatever
+  // page it still sits on.
+  IndexIterator(const IndexIterator &) = delete;
+  auto operator=(const IndexIterator &) -> IndexIterator & = delete;
+  IndexIterator(IndexIterator &&other) noexcept;
+  auto operator=(IndexIterator &&other) noexcept -> IndexIterator &;
+
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -48,10 +56,16 @@ class IndexIterator {
   auto operator!=(const IndexIterator &itr) const -> bool;
 
  private:
+  // Release the latch and pin on the current page, if any.
+  void Release();
+
   // add your own private member variables here
-  BufferPoolManager *bpm_;
-  Page *page_;
+  BufferPoolManager *bpm_{nullptr};
+  Page *page_{nullptr};
   int i_{0};
+  // Entry materialized by operator* (the leaf keeps keys and values in
+  // separate arrays, so there is no stored pair to point into).
+  MappingType cur_;
 };
 
 }  // namespace bustub
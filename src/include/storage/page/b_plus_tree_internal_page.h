@@ -18,8 +18,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 12
-#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 24
+#define INTERNAL_PAGE_SIZE ((BUSTUB_PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -44,12 +44,14 @@ class BPlusTreeInternalPage : public BPlusTreePage {
 
   void Init(int max_size, const ValueType &lhs, const KeyType &mid, const ValueType &rhs);
 
-  auto KeyAt(int index) const -> KeyType;
+  auto KeyAt(int index) const -> const KeyType &;
 
   void SetKeyAt(int index, const KeyType &key);
 
   auto ValueAt(int index) const -> ValueType;
 
+  void SetValueAt(int index, const ValueType &value);
+
   auto Lookup(const KeyType &key, const KeyComparator &comparator) const -> std::pair<ValueType, int>;
 
   void MoveAllTo(BPlusTreeInternalPage *dst);
@@ -91,13 +93,16 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   }
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Keys and child pointers are stored as two parallel arrays
+  // (structure-of-arrays) rather than interleaved pairs, so the separator
+  // search in Lookup touches only key cache lines.
+  KeyType keys_[INTERNAL_PAGE_SIZE];
+  ValueType values_[INTERNAL_PAGE_SIZE];
 
-  void CopyNFrom(int n, MappingType *data);
+  void CopyNFrom(int n, const KeyType *keys, const ValueType *values);
 
-  void CopyToFront(MappingType *data);
+  void CopyToFront(const KeyType &key, const ValueType &value);
 
-  void CopyToBack(MappingType *data);
+  void CopyToBack(const KeyType &key, const ValueType &value);
 };
 }  // namespace bustub
@@ -19,8 +19,8 @@
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 16
-#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 28
+#define LEAF_PAGE_SIZE ((BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(KeyType) + sizeof(ValueType)))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
@@ -32,40 +32,67 @@ namespace bustub {
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 16 bytes in total):
+ *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | (pad 4) | Version (8) |
  *  ---------------------------------------------------------------------
  *  -----------------------------------------------
  * |  NextPageId (4)
  *  -----------------------------------------------
  */
-INDEX_TEMPLATE_ARGUMENTS
-class BPlusTreeLeafPage : public BPlusTreePage {
+/**
+ * The part of the leaf page that does not depend on the key/value types:
+ * header bookkeeping and the sibling link. Explicit instantiation would
+ * otherwise emit one copy of these per key width; here they exist once and
+ * inline at their call sites.
+ */
+class BPlusTreeLeafPageBase : public BPlusTreePage {
  public:
-  // Delete all constructor / destructor to ensure memory safety
-  BPlusTreeLeafPage() = delete;
-  BPlusTreeLeafPage(const BPlusTreeLeafPage &other) = delete;
-
   /**
    * After creating a new leaf page from buffer pool, must call initialize
    * method to set default values
    * @param max_size Max size of the leaf node
    */
-  void Init(int max_size = LEAF_PAGE_SIZE);
+  void Init(int max_size) {
+    ZeroVersion();
+    SetSize(0);
+    SetMaxSize(max_size);
+    SetPageType(IndexPageType::LEAF_PAGE);
+    SetNextPageId(INVALID_PAGE_ID);
+  }
 
-  auto GetNextPageId() const -> page_id_t;
+  auto GetNextPageId() const -> page_id_t { return next_page_id_; }
 
-  void SetNextPageId(page_id_t next_page_id);
-  
-  KeyType KeyAt(int index) const;
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
-  const MappingType& At(int index) const;
+ protected:
+  page_id_t next_page_id_;
+};
+
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeLeafPage : public BPlusTreeLeafPageBase {
+ public:
+  // Delete all constructor / destructor to ensure memory safety
+  BPlusTreeLeafPage() = delete;
+  BPlusTreeLeafPage(const BPlusTreeLeafPage &other) = delete;
+
+
+  // Returns a reference into the page; wide GenericKey instantiations would
+  // otherwise copy up to 64 bytes per call on the search hot path.
+  auto KeyAt(int index) const -> const KeyType &;
+
+  auto ValueAt(int index) const -> ValueType;
 
   auto IndexOfFirstKeyEqualOrGreaterThan(const KeyType &key, const KeyComparator &comparator) const -> std::pair<int, bool>;
 
   auto Lookup(const KeyType &key, ValueType *val, const KeyComparator &comparator) const -> bool;
 
+  // Look up nkeys keys in one call. out[i]/found[i] answer keys[i]. Large
+  // batches are sorted once and resolved with a single merge walk of the
+  // sorted key array — O(n + k) predictable compares instead of k separate
+  // binary searches.
+  void LookupBatch(const KeyType *keys, int nkeys, ValueType *out, bool *found, const KeyComparator &comparator) const;
+
   auto Insert(const KeyType &key, const ValueType &val, const KeyComparator &comparator) -> bool;
 
   void InsertAt(const KeyType &key, const ValueType &val, int i);
@@ -106,14 +133,17 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   }
 
  private:
-  page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[0];
+  // Keys and values are stored as two parallel arrays (structure-of-arrays)
+  // rather than interleaved (key,value) pairs: the binary search only reads
+  // keys, so packing them contiguously halves the cache lines it touches and
+  // keeps the RID payloads out of the way until the final lookup.
+  KeyType keys_[LEAF_PAGE_SIZE];
+  ValueType values_[LEAF_PAGE_SIZE];
 
-  void CopyNFrom(int n, MappingType *data);
+  void CopyNFrom(int n, const KeyType *keys, const ValueType *values);
 
-  void CopyToFront(MappingType *data);
+  void CopyToFront(const KeyType &key, const ValueType &value);
 
-  void CopyToBack(MappingType *data);
+  void CopyToBack(const KeyType &key, const ValueType &value);
 };
 }  // namespace bustub
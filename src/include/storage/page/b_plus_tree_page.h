@@ -33,10 +33,15 @@ enum class IndexPageType { INVALID_INDEX_PAGE = 0, LEAF_PAGE, INTERNAL_PAGE };
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 12 bytes in total):
+ * Header format (size in byte, 24 bytes in total):
  * ----------------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | (pad 4) | Version (8) |
  * ----------------------------------------------------------------------------
+ *
+ * The version counter supports optimistic (latch-free) readers: every mutator
+ * bumps it once before and once after touching the page, so an odd value means
+ * "write in progress" and any change across a speculative read means the read
+ * must be retried.
  */
 class BPlusTreePage {
  public:
@@ -45,26 +50,45 @@ class BPlusTreePage {
   BPlusTreePage(const BPlusTreePage &other) = delete;
   ~BPlusTreePage() = delete;
 
-  auto IsLeafPage() const -> bool;
-  void SetPageType(IndexPageType page_type);
+  // The size accessors are defined here rather than in the translation unit:
+  // every descent tests GetSize() against GetMaxSize()/GetMinSize() once per
+  // level, and inline definitions let those checks compile down to a load and
+  // a compare instead of a function call. (Making the sizes compile-time
+  // constants per instantiation was considered but rejected: the tree's max
+  // sizes are constructor parameters, which the tests and the printer tool
+  // rely on to build small trees.)
+  auto IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
+  void SetPageType(IndexPageType page_type) { page_type_ = page_type; }
+
+  auto GetSize() const -> int { return size_; }
+  void SetSize(int size) { size_ = size; }
+  void IncreaseSize(int amount) { size_ += amount; }
 
-  auto GetSize() const -> int;
-  void SetSize(int size);
-  void IncreaseSize(int amount);
+  auto GetMaxSize() const -> int { return max_size_; }
+  void SetMaxSize(int max_size) { max_size_ = max_size; }
+  auto GetMinSize() const -> int { return (max_size_ + 1) / 2; }
 
-  auto GetMaxSize() const -> int;
-  void SetMaxSize(int max_size);
-  auto GetMinSize() const -> int;
-  
-  auto CanBorrow() const -> bool;
+  auto CanBorrow() const -> bool { return GetSize() > GetMinSize(); }
   // virtual void MoveEndToFrontOf(void *data) = 0;
   // virtual void MoveFrontToEndOf(void *data) = 0;
 
+  // Version counter for optimistic readers. Writers (who hold the page's
+  // write latch) call BumpVersion() on entry and exit of every mutator;
+  // readers snapshot it, read speculatively, and re-check. Pages are cast
+  // from raw buffer frames, so the field can't be a std::atomic member; the
+  // atomic builtins are used on it directly. Writers already serialize
+  // through the page's write latch — the counter only has to make their
+  // mutations visible to latch-free readers.
+  auto Version() const -> uint64_t { return __atomic_load_n(&version_, __ATOMIC_ACQUIRE); }
+  void BumpVersion() { __atomic_fetch_add(&version_, 1, __ATOMIC_RELEASE); }
+  void ZeroVersion() { __atomic_store_n(&version_, 0, __ATOMIC_RELAXED); }
+
  private:
   // member variable, attributes that both internal and leaf page share
   IndexPageType page_type_;
   int size_;
   int max_size_;
+  uint64_t version_;
 };
 
 }  // namespace bustub
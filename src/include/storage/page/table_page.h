@@ -90,6 +90,11 @@ class TablePage {
    */
   auto GetTupleMeta(const RID &rid) const -> TupleMeta;
 
+  /** @return the in-page address of the tuple in the given slot, for prefetching. */
+  auto GetTupleAddress(uint16_t tuple_id) const -> const char * {
+    return page_start_ + std::get<0>(tuple_info_[tuple_id]);
+  }
+
   /**
    * Update a tuple in place.
    */
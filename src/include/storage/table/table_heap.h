@@ -15,6 +15,7 @@
 #include <mutex>  // NOLINT
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "common/config.h"
@@ -53,6 +54,17 @@ class TableHeap {
   auto InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr = nullptr,
                    Transaction *txn = nullptr, table_oid_t oid = 0) -> std::optional<RID>;
 
+  /**
+   * Insert a batch of tuples into the table, taking the heap latch and the tail page's
+   * write latch once for the whole batch instead of once per tuple. Tuples that are too
+   * large (>= page_size) abort the process, same as InsertTuple.
+   * @param meta tuple meta applied to every tuple
+   * @param tuples tuples to insert
+   * @return rids of the inserted tuples, in input order
+   */
+  auto InsertTuples(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr = nullptr,
+                    Transaction *txn = nullptr, table_oid_t oid = 0) -> std::vector<RID>;
+
   /**
    * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
    * @param meta new tuple meta
@@ -65,7 +77,7 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @return the meta and tuple
    */
-  auto GetTuple(RID rid) -> std::pair<TupleMeta, Tuple>;
+  auto GetTuple(RID rid, AccessType access_type = AccessType::Unknown) -> std::pair<TupleMeta, Tuple>;
 
   /**
    * Read a tuple meta from the table. Note: if you want to get tuple and meta together, use `GetTuple` insead
@@ -76,7 +88,7 @@ class TableHeap {
   auto GetTupleMeta(RID rid) -> TupleMeta;
 
   /** @return the iterator of this table, use this for project 3 */
-  auto MakeIterator() -> TableIterator;
+  auto MakeIterator(AccessType access_type = AccessType::Unknown) -> TableIterator;
 
   /** @return the iterator of this table, use this for project 4 except updates */
   auto MakeEagerIterator() -> TableIterator;
@@ -93,6 +105,10 @@ class TableHeap {
   void UpdateTupleInPlaceUnsafe(const TupleMeta &meta, const Tuple &tuple, RID rid);
 
  private:
+  /** Advance page_guard to a page with room for tuple, chaining in a fresh page at the tail
+   * if needed. Caller must hold latch_. */
+  void EnsureSpaceLocked(const TupleMeta &meta, const Tuple &tuple, WritePageGuard &page_guard);
+
   BufferPoolManager *bpm_;
   page_id_t first_page_id_{INVALID_PAGE_ID};
 
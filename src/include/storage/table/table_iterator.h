@@ -16,6 +16,7 @@
 #include <memory>
 #include <utility>
 
+#include "buffer/lru_k_replacer.h"
 #include "common/macros.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
@@ -34,7 +35,7 @@ class TableIterator {
  public:
   DISALLOW_COPY(TableIterator);
 
-  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid);
+  TableIterator(TableHeap *table_heap, RID rid, RID stop_at_rid, AccessType access_type = AccessType::Unknown);
   TableIterator(TableIterator &&) = default;
 
   ~TableIterator() = default;
@@ -47,6 +48,11 @@ class TableIterator {
 
   auto operator++() -> TableIterator &;
 
+  /** @return the in-page address of the tuple the iterator now points at, or nullptr at a page
+   * boundary / end. Cached by operator++ while it already holds the page, so callers can issue a
+   * prefetch without another buffer pool round trip. */
+  auto PeekNextTupleAddress() const -> const char * { return next_tuple_addr_; }
+
  private:
   TableHeap *table_heap_;
   RID rid_;
@@ -55,6 +61,15 @@ class TableIterator {
   // Otherwise we will have dead loops when updating while scanning. (In project 4, update should be implemented as
   // deletion + insertion.)
   RID stop_at_rid_;
+
+  // Access type forwarded to the buffer pool for every page this iterator touches, so
+  // sequential scans can be tagged as such for the replacer.
+  AccessType access_type_{AccessType::Unknown};
+
+  // Address of the tuple rid_ points at, filled in by operator++. The pointer targets the
+  // buffer frame's data array, which stays allocated even if the frame is recycled, so a
+  // stale prefetch is harmless.
+  const char *next_tuple_addr_{nullptr};
 };
 
 }  // namespace bustub
@@ -7,38 +7,53 @@ namespace bustub {
 template <class T>
 auto Trie::Get(std::string_view key) const -> const T * {
   if (!root_) return nullptr;
-  auto node = root_;
+  auto node = root_.get();
   for (auto ch = key.begin(); ch != key.end(); ch++) {
-    auto &children = node->children_;
-    if (!children.count(*ch)) return nullptr;
-    node = children.at(*ch);
+    auto child = node->FindChild(*ch);
+    if (!child) return nullptr;
+    node = child->get();
   }
   if (!node->is_value_node_) return nullptr;
-  auto value_node = dynamic_cast<const TrieNodeWithValue<T> *>(node.get());
-  if (!value_node) return nullptr;
-  return value_node->value_.get();
+  // value_type_ is set by TrieNodeWithValue's constructors, so one type_info comparison
+  // replaces the dynamic_cast RTTI walk.
+  if (!node->value_type_ || *node->value_type_ != typeid(T)) return nullptr;
+  return static_cast<const TrieNodeWithValue<T> *>(node)->ValuePtr();
 }
 
 template <class T>
 auto Trie::Put(std::string_view key, T value) const -> Trie {
-  Trie t;
-  auto val_ptr = std::make_shared<T>(std::move(value));
-  auto node = root_ ? root_->Clone() : std::make_shared<TrieNode>();
-  std::shared_ptr<TrieNode> parent;
-  t.root_ = node;
+  // Walk down, remembering the existing node at every depth (nullptr once the
+  // path leaves the old trie).
+  std::vector<const TrieNode *> path;
+  path.reserve(key.size() + 1);
+  auto node = root_.get();
+  path.push_back(node);
   for (auto ch = key.begin(); ch != key.end(); ch++) {
-    auto &children = node->children_;
-    parent = node;
-    node = children.count(*ch) ? node = children[*ch]->Clone() : std::make_shared<TrieNode>();
-    children[*ch] = node;
+    if (node) {
+      auto child = node->FindChild(*ch);
+      node = child ? child->get() : nullptr;
+    }
+    path.push_back(node);
   }
-  if (key.size()) {
-    auto ch = key.back();
-    parent->children_[ch] = std::make_shared<TrieNodeWithValue<T>>(std::move(node->children_), std::move(val_ptr));
+  // Build the replacement path bottom-up: the new leaf takes over the old
+  // leaf's children, and each ancestor is a shallow copy of its old node with
+  // exactly one child slot pointed at the new subtree. One allocation per
+  // level; every untouched subtree is shared with the old trie.
+  auto old_leaf = path.back();
+  auto children = old_leaf ? old_leaf->children_ : TrieNode::ChildrenMap{};
+  std::shared_ptr<const TrieNode> last;
+  if constexpr (TRIE_VALUE_INLINE<T>) {
+    last = std::make_shared<TrieNodeWithValue<T>>(std::move(children), std::move(value));
   } else {
-    t.root_ = std::make_shared<TrieNodeWithValue<T>>(std::move(node->children_), std::move(val_ptr));
+    last = std::make_shared<TrieNodeWithValue<T>>(std::move(children), std::make_shared<T>(std::move(value)));
   }
-  return t;
+  for (auto i = key.size(); i > 0; i--) {
+    auto old_node = path[i - 1];
+    std::shared_ptr<TrieNode> parent = old_node ? std::shared_ptr<TrieNode>(old_node->Clone()) : std::make_shared<TrieNode>();
+    parent->SetChild(key[i - 1], std::move(last));
+    last = std::move(parent);
+  }
+  return Trie(std::move(last));
 }
 
 auto Trie::Remove(std::string_view key) const -> Trie {
@@ -47,9 +62,9 @@ auto Trie::Remove(std::string_view key) const -> Trie {
   std::vector<std::shared_ptr<const TrieNode>> vec;
   vec.push_back(root_);
   for (auto ch = key.begin(); ch != key.end(); ch++) {
-    auto &children = vec.back()->children_;
-    if (!children.count(*ch)) break;
-    vec.push_back(children.at(*ch));
+    auto child = vec.back()->FindChild(*ch);
+    if (!child) break;
+    vec.push_back(*child);
   }
   if (vec.size() != key.size() + 1 || !vec.back()->is_value_node_) {
     t.root_ = root_->Clone();
@@ -61,11 +76,11 @@ auto Trie::Remove(std::string_view key) const -> Trie {
   for (auto ch = key.rbegin(); ch != key.rend(); ch++) {
     if (last) {
       auto node = vec.back()->Clone();
-      node->children_[*ch] = last;
+      node->SetChild(*ch, last);
       last = std::move(node);
     } else if (vec.back()->children_.size() > 1 || vec.back()->is_value_node_) {
       auto node = vec.back()->Clone();
-      node->children_.erase(*ch);
+      node->RemoveChild(*ch);
       last = std::move(node);
     } else {
       last = nullptr;
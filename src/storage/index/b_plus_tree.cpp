@@ -1,3 +1,6 @@
+#include <cctype>
+#include <charconv>
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -26,7 +29,9 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, page_id_t header_page_id, BufferPool
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
+auto BPLUSTREE_TYPE::IsEmpty() const -> bool {
+  return cached_root_pid_.load(std::memory_order_acquire) == INVALID_PAGE_ID;
+}
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -35,8 +40,59 @@ auto BPLUSTREE_TYPE::IsEmpty() const -> bool { return true; }
  * This method is used for point query
  * @return : true means key exists
  */
+/*
+ * Optimistic descent: pin each page without taking its read latch and use the
+ * per-page version counter to detect concurrent writers. Every FetchPageRead
+ * the latched path saves is one less trip through the buffer pool's RW latch,
+ * which is the dominant contention point on the root at high read concurrency.
+ * A validated hit is definitive. A miss is NOT: a split moves keys to the new
+ * sibling before the separator reaches the parent, so a speculative reader can
+ * slip between the two and land on a leaf that just shed its upper half.
+ * Returns true only when the key was found and the read validated; every other
+ * outcome means the caller must re-run the latched descent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::GetValueOptimistic(const KeyType &key, std::vector<ValueType> *result) -> bool {
+  // The cached root id replaces a buffer-pool fetch of the header page — a
+  // hash lookup plus a pin on the one page every query shares. The load is
+  // as current as the header frame read it replaces: either way the root can
+  // move right afterwards, and the version validation below (or the latched
+  // fallback) absorbs that.
+  auto pid = cached_root_pid_.load(std::memory_order_acquire);
+  if (pid == INVALID_PAGE_ID) return false;
+  BasicPageGuard g = bpm_->FetchPageBasic(pid);
+  auto page = g.As<InternalPage>();
+  auto v = page->Version();
+  // An odd version means a writer is mid-mutation on this page.
+  while (!(v & 1)) {
+    if (page->IsLeafPage()) {
+      auto leaf_page = g.As<LeafPage>();
+      ValueType val;
+      auto found = leaf_page->Lookup(key, &val, comparator_);
+      if (!found || page->Version() != v) return false;
+      result->push_back(val);
+      return true;
+    }
+    pid = page->Lookup(key, comparator_).first;
+    // Warm the child's page-table bucket while the parent is re-validated.
+    bpm_->PrefetchLookup(pid);
+    if (page->Version() != v) return false;
+    BasicPageGuard child = bpm_->FetchPageBasic(pid);
+    auto child_page = child.As<InternalPage>();
+    auto cv = child_page->Version();
+    // Re-validate the parent after snapshotting the child's version, so a
+    // child split between the two reads can't go unnoticed.
+    if (page->Version() != v) return false;
+    g = std::move(child);
+    page = child_page;
+    v = cv;
+  }
+  return false;
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *txn) -> bool {
+  if (GetValueOptimistic(key, result)) return true;
   ReadPageGuard rg = bpm_->FetchPageRead(header_page_id_);
   auto root_page = rg.As<BPlusTreeHeaderPage>();
   auto pid = root_page->root_page_id_;
@@ -53,20 +109,128 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
       return true;
     } else {
       pid = internal_page->Lookup(key, comparator_).first;
+      bpm_->PrefetchLookup(pid);
       ReadPageGuard rg_2 = bpm_->FetchPageRead(pid);
       rg_1 = std::move(rg_2);
     }
   }
 }
 
-#define PRE_INSERT_AND_REMOVE WritePageGuard header_wg = bpm_->FetchPageWrite(header_page_id_); \
-                              auto header_page = header_wg.As<BPlusTreeHeaderPage>();           \
-                              auto pid = header_page->root_page_id_;                            \
-                              std::deque<WritePageGuard> guards;                                \
-                              auto release_all = [&]{                                           \
-                                header_wg.Drop();                                               \
-                                while (guards.size()) guards.pop_front();                       \
-                              };                                                                \
+/*
+ * Point-look-up a batch of keys in one call.
+ * All keys descend the tree in lockstep: each level first fetches every
+ * frontier page and issues a prefetch for its key area, then runs the
+ * searches. With several lookups in flight the cache misses of one key's
+ * page overlap with the comparisons of the others, instead of each
+ * point query paying the full root-to-leaf latency serially.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValueBatch(const std::vector<KeyType> &keys, std::vector<std::vector<ValueType>> *result,
+                                   Transaction *txn) {
+  result->clear();
+  result->resize(keys.size());
+  if (keys.empty()) return;
+  // Every in-flight key pins its frontier page, so the whole batch at once
+  // could demand more frames than the pool has and wedge FetchPage. Cap the
+  // number of concurrent descents at half the pool (the transient child+parent
+  // overlap during latch coupling pins one extra frame per key) and run the
+  // batch in slices.
+  auto slice = std::max<size_t>(1, bpm_->GetPoolSize() / 2);
+  for (size_t lo = 0; lo < keys.size(); lo += slice) {
+    auto hi = std::min(lo + slice, keys.size());
+    ReadPageGuard rg = bpm_->FetchPageRead(header_page_id_);
+    auto root_page = rg.As<BPlusTreeHeaderPage>();
+    auto root_pid = root_page->root_page_id_;
+    if (root_pid == INVALID_PAGE_ID) return;
+    std::vector<ReadPageGuard> guards(hi - lo);
+    std::vector<bool> done(hi - lo, false);
+    for (size_t i = lo; i < hi; i++) guards[i - lo] = bpm_->FetchPageRead(root_pid);
+    rg.Drop();
+    size_t remaining = hi - lo;
+    while (remaining > 0) {
+      // Phase 1: warm the cache for every frontier page before any search runs.
+      for (size_t i = lo; i < hi; i++) {
+        if (done[i - lo]) continue;
+        auto data = guards[i - lo].template As<char>();
+        __builtin_prefetch(data);
+        __builtin_prefetch(data + BUSTUB_PAGE_SIZE / 2);
+      }
+      // Phase 2: advance each key one level; keys that reached a leaf are
+      // grouped per page so all probes into one leaf run as a single merge
+      // walk (LeafPage::LookupBatch) instead of independent binary searches.
+      std::unordered_map<const void *, std::vector<size_t>> arrived;
+      for (size_t i = lo; i < hi; i++) {
+        if (done[i - lo]) continue;
+        auto internal_page = guards[i - lo].template As<InternalPage>();
+        if (internal_page->IsLeafPage()) {
+          arrived[internal_page].push_back(i);
+        } else {
+          auto pid = internal_page->Lookup(keys[i], comparator_).first;
+          // Move-assignment fetches the child before the parent guard drops,
+          // the same latch-coupling order GetValue uses.
+          guards[i - lo] = bpm_->FetchPageRead(pid);
+        }
+      }
+      for (auto &[_, idxs] : arrived) {
+        auto leaf_page = guards[idxs[0] - lo].template As<LeafPage>();
+        std::vector<KeyType> batch_keys;
+        batch_keys.reserve(idxs.size());
+        for (auto i : idxs) batch_keys.push_back(keys[i]);
+        std::vector<ValueType> vals(idxs.size());
+        auto hits = std::make_unique<bool[]>(idxs.size());
+        leaf_page->LookupBatch(batch_keys.data(), static_cast<int>(idxs.size()), vals.data(), hits.get(), comparator_);
+        for (size_t k = 0; k < idxs.size(); k++) {
+          auto i = idxs[k];
+          if (hits[k]) (*result)[i].push_back(vals[k]);
+          guards[i - lo].Drop();
+          done[i - lo] = true;
+          remaining--;
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Optimistic write descent: crab down with read latches and take the write
+ * latch only on the target leaf. Holding the parent's read latch while the
+ * leaf write latch is acquired keeps the routing stable (a split would have
+ * to post a separator into the read-latched parent), and latches are only
+ * ever taken top-down, so this cannot deadlock with the pessimistic path.
+ * Bails out (empty optional) on an empty tree or when the root itself is the
+ * leaf — the pessimistic path handles those. The caller must still verify the
+ * leaf is safe for its operation and restart pessimistically if not.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::OptimisticLeafWrite(const KeyType &key) -> std::optional<WritePageGuard> {
+  page_id_t pid;
+  ReadPageGuard rg;
+  while (1) {
+    pid = cached_root_pid_.load(std::memory_order_acquire);
+    if (pid == INVALID_PAGE_ID) return std::nullopt;
+    rg = bpm_->FetchPageRead(pid);
+    // The root may have moved between the load and the latch, leaving this
+    // guard on a stale subtree that no longer covers the whole key space.
+    // Once the latch is held the root can't change (both root split and root
+    // collapse write-latch it), so one re-check closes the window.
+    if (cached_root_pid_.load(std::memory_order_acquire) == pid) break;
+    rg.Drop();
+  }
+  if (rg.As<InternalPage>()->IsLeafPage()) return std::nullopt;
+  while (1) {
+    auto internal_page = rg.As<InternalPage>();
+    pid = internal_page->Lookup(key, comparator_).first;
+    bpm_->PrefetchLookup(pid);
+    ReadPageGuard child = bpm_->FetchPageRead(pid);
+    if (child.As<InternalPage>()->IsLeafPage()) {
+      // Re-fetch the leaf with a write latch. The parent's read latch stays
+      // held across the handoff, so the leaf can't be split out from under us.
+      child.Drop();
+      return bpm_->FetchPageWrite(pid);
+    }
+    rg = std::move(child);
+  }
+}
 
 /*****************************************************************************
  * INSERTION
@@ -77,49 +241,96 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * entry, otherwise insert into leaf page.
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
+ *
+ * Splits stay bottom-up on purpose. Top-down preparation (pre-splitting any
+ * full node during descent so at most two write latches are ever held) does
+ * not conform to this tree's fill invariant: with min = (max+1)/2, splitting
+ * a full node without the incoming entry leaves one half below its minimum
+ * whenever max is odd — and both the test configurations and the default
+ * INTERNAL_PAGE_SIZE are odd. Under-filled internal nodes break Borrow/Merge,
+ * which index siblings assuming every non-root node holds at least min
+ * entries. The incoming entry is exactly what makes the bottom-up split able
+ * to produce two conforming halves. The optimistic leaf-only descent above
+ * already keeps ancestors free of write latches for every non-splitting
+ * insert, which is the common case this rewrite would have targeted.
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *txn) -> bool {
-  PRE_INSERT_AND_REMOVE
+  // Duplicate probe before any latching: a validated optimistic lookup that
+  // finds the key means the insert is a reject, and rejecting without ever
+  // taking a write latch keeps hot duplicate traffic off the writers. Only a
+  // confirmed hit short-circuits; a miss or a version conflict proves
+  // nothing and falls through to the latched paths, whose own leaf-level
+  // existence check stays authoritative.
+  {
+    std::vector<ValueType> scratch;
+    if (GetValueOptimistic(key, &scratch)) return false;
+  }
+  // Fast path: almost no insert propagates a split, so try a descent that
+  // write-latches only the leaf before falling back to full write latching.
+  {
+    std::optional<WritePageGuard> owg = OptimisticLeafWrite(key);
+    if (owg.has_value()) {
+      auto leaf_page = owg->As<LeafPage>();
+      auto res = leaf_page->IndexOfFirstKeyEqualOrGreaterThan(key, comparator_);
+      if (res.second) return false;
+      if (leaf_page->GetSize() < leaf_page->GetMaxSize()) {
+        owg->AsMut<LeafPage>()->InsertAt(key, value, res.first);
+        return true;
+      }
+      // The leaf would split; restart with the pessimistic descent.
+    }
+  }
+  DescentContext ctx(bpm_, header_page_id_);
+  auto pid = ctx.RootPageId();
   if (pid == INVALID_PAGE_ID) {
-    Page *page = bpm_->NewPage(&pid);
-    BUSTUB_ASSERT(page, "Failed to create new page.");
-    WritePageGuard leaf_wg = {bpm_, page};
+    WritePageGuard leaf_wg = bpm_->NewPageWrite(&pid);
     auto leaf_page = leaf_wg.AsMut<LeafPage>();
     leaf_page->Init(leaf_max_size_);
     leaf_page->Insert(key, value, comparator_);
-    auto header_page = header_wg.AsMut<BPlusTreeHeaderPage>();
-    header_page->root_page_id_ = page->GetPageId();
+    auto header_page = ctx.header_wg_.AsMut<BPlusTreeHeaderPage>();
+    header_page->root_page_id_ = pid;
+    cached_root_pid_.store(pid, std::memory_order_release);
     return true;
   }
-  std::deque<int> indexes;
   do {
     WritePageGuard wg = bpm_->FetchPageWrite(pid);
     auto internal_page = wg.As<InternalPage>();
-    if (internal_page->GetSize() < internal_page->GetMaxSize()) release_all();
-    guards.push_back(std::move(wg));
+    if (internal_page->GetSize() < internal_page->GetMaxSize()) ctx.ReleaseAll();
+    ctx.guards_.PushBack({std::move(wg), -1});
     if (internal_page->IsLeafPage()) break;
     auto res = internal_page->Lookup(key, comparator_);
     pid = res.first;
-    indexes.push_back(res.second);
+    bpm_->PrefetchLookup(pid);
+    ctx.guards_.Back().child_index_ = res.second;
   } while (1);
   // 
   page_id_t last;
-  std::pair<KeyType, page_id_t> up;
-  auto &wg = guards.back();
+  // The promoted separator stays in the freshly split sibling; carrying a
+  // pointer to it (plus the sibling's page id) avoids copying the key once
+  // per level, which matters for the wide GenericKey instantiations. The
+  // sibling's guard is parked in sibling_wg so the pointee stays pinned
+  // until the parent's InsertAt has consumed it.
+  page_id_t up_pid;
+  const KeyType *up_key;
+  WritePageGuard sibling_wg;
+  auto &wg = ctx.guards_.Back().guard_;
   auto leaf_page = wg.As<LeafPage>();
   auto res = leaf_page->IndexOfFirstKeyEqualOrGreaterThan(key, comparator_);
   if (res.second) {
-    release_all();
+    ctx.ReleaseAll();
     return false;
   } else if (leaf_page->GetSize() < leaf_page->GetMaxSize()) {
     auto leaf_page_w = wg.AsMut<LeafPage>();
     leaf_page_w->InsertAt(key, value, res.first);
     return true;
   } else {
-    Page *page = bpm_->NewPage(&pid);
-    BUSTUB_ASSERT(page, "Failed to create new page.");
-    WritePageGuard wg1 = {bpm_, page};
+    // Split pages come straight from NewPage. A per-tree slab of pre-allocated
+    // pages was considered and rejected: NewPage here is a lock-free free-list
+    // pop plus one shard-table insert, whereas a slab page is unpinned and
+    // would have to come back through FetchPage (page-table lookup, possible
+    // disk read) — strictly more work than allocating fresh.
+    WritePageGuard wg1 = bpm_->NewPageWrite(&pid);
     auto leaf_page_new = wg1.AsMut<LeafPage>();
     auto leaf_page_cur = wg.AsMut<LeafPage>();
     leaf_page_new->Init(leaf_max_size_);
@@ -130,41 +341,41 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
       leaf_page_cur->InsertAt(key, value, res.first) :
       leaf_page_new->InsertAt(key, value, res.first - leaf_page_cur->GetSize());
     last = wg.PageId();
-    up = std::make_pair(leaf_page_new->KeyAt(0), pid);
-    guards.pop_back();
+    up_pid = pid;
+    up_key = &leaf_page_new->KeyAt(0);
+    sibling_wg = std::move(wg1);
+    ctx.guards_.PopBack();
   }
-  while (guards.size()) {
-    WritePageGuard wg = std::move(guards.back());
-    guards.pop_back();
+  while (ctx.guards_.Size()) {
+    auto i = ctx.guards_.Back().child_index_;
+    WritePageGuard wg = std::move(ctx.guards_.Back().guard_);
+    ctx.guards_.PopBack();
     last = wg.PageId();
     auto internal_page_cur = wg.AsMut<InternalPage>();
-    auto i = indexes.back();
-    indexes.pop_back();
     if (internal_page_cur->GetSize() < internal_page_cur->GetMaxSize()) {
-      internal_page_cur->InsertAt(up.first, up.second, i + 1);
+      internal_page_cur->InsertAt(*up_key, up_pid, i + 1);
       return true;
     }
-    Page *page = bpm_->NewPage(&pid);
-    BUSTUB_ASSERT(page, "Failed to create new page.");
-    WritePageGuard wg1 = {bpm_, page};
+    WritePageGuard wg1 = bpm_->NewPageWrite(&pid);
     auto internal_page_new = wg1.AsMut<InternalPage>();
     internal_page_new->Init(internal_max_size_);
     internal_page_cur->MoveHalfTo(internal_page_new);
     i < internal_page_cur->GetSize() ?
-      internal_page_cur->InsertAt(up.first, up.second, i + 1) :
-      internal_page_new->InsertAt(up.first, up.second, i - internal_page_cur->GetSize() + 1);
+      internal_page_cur->InsertAt(*up_key, up_pid, i + 1) :
+      internal_page_new->InsertAt(*up_key, up_pid, i - internal_page_cur->GetSize() + 1);
     if (internal_page_new->GetSize() < internal_page_new->GetMinSize()) {
       internal_page_cur->MoveBackToFrontOf(internal_page_new);
     }
-    up = std::make_pair(internal_page_new->KeyAt(0), pid);
+    up_pid = pid;
+    up_key = &internal_page_new->KeyAt(0);
+    sibling_wg = std::move(wg1);
   }
-  Page *page = bpm_->NewPage(&pid);
-  BUSTUB_ASSERT(page, "Failed to create new page.");
-  WritePageGuard wg1 = {bpm_, page};
+  WritePageGuard wg1 = bpm_->NewPageWrite(&pid);
   auto internal_page_new = wg1.AsMut<InternalPage>();
-  internal_page_new->Init(internal_max_size_, last, up.first, up.second);
-  auto header_page_w = header_wg.AsMut<BPlusTreeHeaderPage>();
-  header_page_w->root_page_id_ = page->GetPageId();
+  internal_page_new->Init(internal_max_size_, last, *up_key, up_pid);
+  auto header_page_w = ctx.header_wg_.AsMut<BPlusTreeHeaderPage>();
+  header_page_w->root_page_id_ = pid;
+  cached_root_pid_.store(pid, std::memory_order_release);
   return true;
 }
 
@@ -180,50 +391,74 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *txn) {
-  PRE_INSERT_AND_REMOVE
+  // Fast path, mirroring Insert: if the leaf stays at or above its minimum
+  // after the removal, no borrow/merge can propagate and the ancestors never
+  // needed write latches.
+  {
+    std::optional<WritePageGuard> owg = OptimisticLeafWrite(key);
+    if (owg.has_value()) {
+      auto leaf_page = owg->As<LeafPage>();
+      if (leaf_page->GetSize() > leaf_page->GetMinSize()) {
+        auto res = leaf_page->IndexOfFirstKeyEqualOrGreaterThan(key, comparator_);
+        if (res.second) owg->AsMut<LeafPage>()->Remove(res.first);
+        return;
+      }
+      // The leaf is at its minimum; restart with the pessimistic descent.
+    }
+  }
+  DescentContext ctx(bpm_, header_page_id_);
+  auto pid = ctx.RootPageId();
   if (pid == INVALID_PAGE_ID) return;
-  std::deque<int> indexes;
   do {
     WritePageGuard wg = bpm_->FetchPageWrite(pid);
     auto internal_page = wg.As<InternalPage>();
-    if (internal_page->GetSize() > internal_page->GetMinSize()) release_all();
-    guards.push_back(std::move(wg));
+    if (internal_page->GetSize() > internal_page->GetMinSize()) ctx.ReleaseAll();
+    ctx.guards_.PushBack({std::move(wg), -1});
     if (internal_page->IsLeafPage()) break;
     auto res = internal_page->Lookup(key, comparator_);
     pid = res.first;
-    indexes.push_back(res.second);
+    bpm_->PrefetchLookup(pid);
+    ctx.guards_.Back().child_index_ = res.second;
   } while(1);
-  auto &wg_leaf = guards.back();
+  auto &wg_leaf = ctx.guards_.Back().guard_;
   auto leaf_page = wg_leaf.As<LeafPage>();
   auto res = leaf_page->IndexOfFirstKeyEqualOrGreaterThan(key, comparator_);
   if (!res.second) {
-    release_all();
+    ctx.ReleaseAll();
     return;
   }
   auto leaf_page_cur = wg_leaf.AsMut<LeafPage>();
   leaf_page_cur->Remove(res.first);
   if (leaf_page_cur->GetSize() >= leaf_page_cur->GetMinSize()) return;
   auto isChildLeaf = true;
-  while (guards.size() >= 2) {
-    auto wg_child = std::move(guards.back());
-    guards.pop_back();
-    auto &wg_parent = guards.back();
-    if (Borrow(wg_parent, wg_child, indexes.back(), isChildLeaf)) {
-      release_all();
-      return; 
+  while (ctx.guards_.Size() >= 2) {
+    auto wg_child = std::move(ctx.guards_.Back().guard_);
+    ctx.guards_.PopBack();
+    auto &parent_entry = ctx.guards_.Back();
+    auto &wg_parent = parent_entry.guard_;
+    if (Borrow(wg_parent, wg_child, parent_entry.child_index_, isChildLeaf)) {
+      ctx.ReleaseAll();
+      return;
     }
-    Merge(wg_parent, wg_child, indexes.back(), isChildLeaf);
+    auto dead_pid = Merge(wg_parent, wg_child, parent_entry.child_index_, isChildLeaf);
+    wg_child.Drop();
+    bpm_->DeletePage(dead_pid);
     isChildLeaf = false;
-    indexes.pop_back();
   }
-  WritePageGuard &wg = guards.back();
+  WritePageGuard &wg = ctx.guards_.Back().guard_;
   auto internal_page_r = wg.As<InternalPage>();
   if (internal_page_r->GetSize() >= internal_page_r->GetMinSize() || internal_page_r->IsLeafPage()) {
     return;
   } else if (internal_page_r->GetSize() == 1) {
-    auto internal_page = wg.AsMut<InternalPage>();
-    auto header_page_w = header_wg.AsMut<BPlusTreeHeaderPage>();
-    header_page_w->root_page_id_ = internal_page->ValueAt(0);
+    // Reading the old root's only child doesn't modify it; re-casting with
+    // AsMut here would mark the page dirty for nothing.
+    auto header_page_w = ctx.header_wg_.AsMut<BPlusTreeHeaderPage>();
+    header_page_w->root_page_id_ = internal_page_r->ValueAt(0);
+    cached_root_pid_.store(header_page_w->root_page_id_, std::memory_order_release);
+    // The old root is unreachable now; give its page back too.
+    auto dead_pid = wg.PageId();
+    ctx.ReleaseAll();
+    bpm_->DeletePage(dead_pid);
   }
 }
 
@@ -259,42 +494,45 @@ auto BPLUSTREE_TYPE::Borrow(WritePageGuard &parent, WritePageGuard &child, int c
   return false;
 }
 
-#define MERGE(type) auto cur_page = child.AsMut<type>();          \
-                    auto sibling_page = sibling_pg.AsMut<type>(); \
-                    r == childIndex ?                             \
-                      cur_page->MoveAllTo(sibling_page) :         \
-                      sibling_page->MoveAllTo(cur_page);          \
-
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Merge(WritePageGuard &parent, WritePageGuard &child, int childIndex, bool isChildLeaf) {
+auto BPLUSTREE_TYPE::Merge(WritePageGuard &parent, WritePageGuard &child, int childIndex, bool isChildLeaf)
+    -> page_id_t {
+  // Cast each page exactly once per scope: every AsMut re-derives the page
+  // pointer and marks the page dirty, and the size probe below only reads.
   auto parent_page = parent.AsMut<InternalPage>();
   int r = childIndex;
-  // TODO:
-  if (child.AsMut<InternalPage>()->GetSize()) {
+  // The page whose entries move away is dead after the merge; report it so
+  // the caller can hand it back to the buffer pool once its guard is dropped.
+  auto dead_pid = child.PageId();
+  if (child.As<InternalPage>()->GetSize()) {
     int l = childIndex > 0 ? childIndex - 1 : childIndex;
     r = l + 1;
-    BasicPageGuard sibling_pg = r == childIndex ?
-                                  bpm_->FetchPageBasic(parent_page->ValueAt(l)) : 
-                                  bpm_->FetchPageBasic(parent_page->ValueAt(r));
+    BasicPageGuard sibling_pg = bpm_->FetchPageBasic(parent_page->ValueAt(r == childIndex ? l : r));
+    if (r != childIndex) dead_pid = sibling_pg.PageId();
     if (isChildLeaf) {
       auto cur_page = child.AsMut<LeafPage>();
       auto sibling_page = sibling_pg.AsMut<LeafPage>();
-      r == childIndex ?
-        sibling_page->SetNextPageId(cur_page->GetNextPageId()) :
+      if (r == childIndex) {
+        sibling_page->SetNextPageId(cur_page->GetNextPageId());
+        cur_page->MoveAllTo(sibling_page);
+      } else {
         cur_page->SetNextPageId(sibling_page->GetNextPageId());
+        sibling_page->MoveAllTo(cur_page);
+      }
     } else {
-      r == childIndex ?
-        child.AsMut<InternalPage>()->SetKeyAt(0, parent_page->KeyAt(r)) :
-        sibling_pg.AsMut<InternalPage>()->SetKeyAt(0, parent_page->KeyAt(r));
-    }
-    if (isChildLeaf) {
-      MERGE(LeafPage)
-    } else {
-      MERGE(InternalPage)
+      auto cur_page = child.AsMut<InternalPage>();
+      auto sibling_page = sibling_pg.AsMut<InternalPage>();
+      if (r == childIndex) {
+        cur_page->SetKeyAt(0, parent_page->KeyAt(r));
+        cur_page->MoveAllTo(sibling_page);
+      } else {
+        sibling_page->SetKeyAt(0, parent_page->KeyAt(r));
+        sibling_page->MoveAllTo(cur_page);
+      }
     }
   }
-  // TODO: deallocate the page
   parent_page->Remove(r);
+  return dead_pid;
 }
 
 /*****************************************************************************
@@ -335,32 +573,191 @@ auto BPLUSTREE_TYPE::End() -> INDEXITERATOR_TYPE {
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::GetRootPageId() -> page_id_t {
-  ReadPageGuard header_rg = bpm_->FetchPageRead(header_page_id_);
-  auto header_page = header_rg.As<BPlusTreeHeaderPage>();
-  auto pid = header_page->root_page_id_;
-  return pid;
+  return cached_root_pid_.load(std::memory_order_acquire);
 }
 
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
 
+/*
+ * Leaf pages are allocated in split order, so after random inserts a range
+ * scan following next_page_id_ hops across physically scattered pages. Copy
+ * the leaf chain in key order into freshly allocated pages — NewPage hands out
+ * consecutive ids, so key-adjacent leaves become page-id-adjacent — rewrite
+ * the parents' child pointers, and free the old leaves. Offline only: the
+ * header write latch is held throughout, which blocks every latched
+ * operation; concurrent optimistic readers are caught by the parents' version
+ * bumps, exactly as with any other structure modification.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Compact() {
+  WritePageGuard header_wg = bpm_->FetchPageWrite(header_page_id_);
+  auto root_pid = header_wg.As<BPlusTreeHeaderPage>()->root_page_id_;
+  if (root_pid == INVALID_PAGE_ID) return;
+  // Find the leftmost leaf.
+  auto pid = root_pid;
+  while (1) {
+    BasicPageGuard g = bpm_->FetchPageBasic(pid);
+    auto page = g.template As<InternalPage>();
+    if (page->IsLeafPage()) break;
+    pid = page->ValueAt(0);
+  }
+  // Copy the leaf chain left to right. Each new leaf's next pointer still
+  // holds the old successor id from the byte copy; it is patched once the
+  // successor's new page exists.
+  std::unordered_map<page_id_t, page_id_t> relocated;
+  auto prev_new_pid = INVALID_PAGE_ID;
+  while (pid != INVALID_PAGE_ID) {
+    BasicPageGuard old_g = bpm_->FetchPageBasic(pid);
+    page_id_t new_pid;
+    WritePageGuard new_g = bpm_->NewPageWrite(&new_pid);
+    memcpy(new_g.GetDataMut(), old_g.GetData(), BUSTUB_PAGE_SIZE);
+    relocated[pid] = new_pid;
+    if (prev_new_pid != INVALID_PAGE_ID) {
+      WritePageGuard prev_g = bpm_->FetchPageWrite(prev_new_pid);
+      prev_g.AsMut<LeafPage>()->SetNextPageId(new_pid);
+    }
+    prev_new_pid = new_pid;
+    pid = old_g.template As<LeafPage>()->GetNextPageId();
+  }
+  if (relocated.count(root_pid)) {
+    // The root is the only leaf.
+    header_wg.AsMut<BPlusTreeHeaderPage>()->root_page_id_ = relocated[root_pid];
+    cached_root_pid_.store(relocated[root_pid], std::memory_order_release);
+  } else {
+    RelinkLeaves(root_pid, relocated);
+  }
+  for (const auto &entry : relocated) bpm_->DeletePage(entry.first);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RelinkLeaves(page_id_t pid, const std::unordered_map<page_id_t, page_id_t> &relocated) {
+  WritePageGuard g = bpm_->FetchPageWrite(pid);
+  auto page = g.As<InternalPage>();
+  BasicPageGuard first_child = bpm_->FetchPageBasic(page->ValueAt(0));
+  if (first_child.template As<BPlusTreePage>()->IsLeafPage()) {
+    auto page_w = g.AsMut<InternalPage>();
+    for (int i = 0; i < page_w->GetSize(); i++) page_w->SetValueAt(i, relocated.at(page_w->ValueAt(i)));
+  } else {
+    for (int i = 0; i < page->GetSize(); i++) RelinkLeaves(page->ValueAt(i), relocated);
+  }
+}
+
+/*
+ * Sorting first turns the build into purely sequential page writes: the leaves
+ * are packed left to right at ~90% fill (never below the min-size invariant),
+ * then each internal level is assembled from the (first key, page id) pairs of
+ * the level below. Inserting N keys one by one costs N root-to-leaf descents
+ * and a split every ~fanout keys; the bottom-up build touches each page
+ * exactly once and never splits.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoad(std::vector<std::pair<KeyType, ValueType>> kvs, Transaction *txn) {
+  std::sort(kvs.begin(), kvs.end(),
+            [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) < 0; });
+  // Only unique keys are supported; keep the first of each equal run.
+  kvs.erase(std::unique(kvs.begin(), kvs.end(),
+                        [this](const auto &a, const auto &b) { return comparator_(a.first, b.first) == 0; }),
+            kvs.end());
+  if (kvs.empty()) return;
+  WritePageGuard header_wg = bpm_->FetchPageWrite(header_page_id_);
+  auto header_page = header_wg.AsMut<BPlusTreeHeaderPage>();
+  if (header_page->root_page_id_ != INVALID_PAGE_ID) {
+    // The bottom-up build assumes it owns the whole key space. On a non-empty
+    // tree fall back to ordinary inserts — still cheaper than unsorted input,
+    // since consecutive keys keep hitting the same leaf.
+    header_wg.Drop();
+    for (const auto &kv : kvs) Insert(kv.first, kv.second, txn);
+    return;
+  }
+  // Nodes per level: aim for ~90% fill, then distribute the entries evenly so
+  // no node lands below GetMinSize(). With min = (max+1)/2 such a distribution
+  // always exists; a single node (the root) is exempt from the minimum.
+  auto plan = [](size_t n, int max_size) -> size_t {
+    auto min_size = static_cast<size_t>((max_size + 1) / 2);
+    auto target = std::max(min_size, static_cast<size_t>(max_size) * 9 / 10);
+    auto nodes = (n + target - 1) / target;
+    while (nodes > 1 && n / nodes < min_size && (n + nodes - 2) / (nodes - 1) <= static_cast<size_t>(max_size)) {
+      nodes--;
+    }
+    return nodes;
+  };
+  // Leaf level.
+  std::vector<std::pair<KeyType, page_id_t>> level;
+  {
+    auto n = kvs.size();
+    auto nodes = plan(n, leaf_max_size_);
+    level.reserve(nodes);
+    size_t taken = 0;
+    WritePageGuard prev_wg;
+    for (size_t i = 0; i < nodes; i++) {
+      auto count = n / nodes + (i < n % nodes ? 1 : 0);
+      page_id_t pid;
+      WritePageGuard wg = bpm_->NewPageWrite(&pid);
+      auto leaf_page = wg.AsMut<LeafPage>();
+      leaf_page->Init(leaf_max_size_);
+      for (size_t j = 0; j < count; j++, taken++) {
+        leaf_page->InsertAt(kvs[taken].first, kvs[taken].second, static_cast<int>(j));
+      }
+      if (i > 0) prev_wg.AsMut<LeafPage>()->SetNextPageId(pid);
+      level.emplace_back(leaf_page->KeyAt(0), pid);
+      prev_wg = std::move(wg);
+    }
+  }
+  // Internal levels, bottom to top.
+  while (level.size() > 1) {
+    auto n = level.size();
+    auto nodes = plan(n, internal_max_size_);
+    std::vector<std::pair<KeyType, page_id_t>> next;
+    next.reserve(nodes);
+    size_t taken = 0;
+    for (size_t i = 0; i < nodes; i++) {
+      auto count = n / nodes + (i < n % nodes ? 1 : 0);
+      page_id_t pid;
+      WritePageGuard wg = bpm_->NewPageWrite(&pid);
+      auto internal_page = wg.AsMut<InternalPage>();
+      internal_page->Init(internal_max_size_);
+      auto first_key = level[taken].first;
+      for (size_t j = 0; j < count; j++, taken++) {
+        internal_page->InsertAt(level[taken].first, level[taken].second, static_cast<int>(j));
+      }
+      next.emplace_back(first_key, pid);
+    }
+    level = std::move(next);
+  }
+  header_page->root_page_id_ = level[0].second;
+  cached_root_pid_.store(level[0].second, std::memory_order_release);
+}
+
 /*
  * This method is used for test only
- * Read data from file and insert one by one
+ * Read all keys from file, then bulk load them in one pass
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *txn) {
-  int64_t key;
+  // getline + from_chars instead of operator>>: no locale machinery per token,
+  // and a failed parse on a trailing blank line is skipped instead of
+  // re-delivering the previous key the way `while (input) { input >> key; }`
+  // did.
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-
-    KeyType index_key;
-    index_key.SetFromInteger(key);
-    RID rid(key);
-    Insert(index_key, rid, txn);
+  std::vector<std::pair<KeyType, ValueType>> kvs;
+  std::string line;
+  while (std::getline(input, line)) {
+    const char *p = line.data();
+    const char *end = p + line.size();
+    while (p < end) {
+      while (p < end && std::isspace(*p)) p++;
+      int64_t key;
+      auto res = std::from_chars(p, end, key);
+      if (res.ec != std::errc()) break;
+      p = res.ptr;
+      KeyType index_key;
+      index_key.SetFromInteger(key);
+      kvs.emplace_back(index_key, RID(key));
+    }
   }
+  BulkLoad(std::move(kvs), txn);
 }
 /*
  * This method is used for test only
@@ -368,59 +765,83 @@ void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *t
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::RemoveFromFile(const std::string &file_name, Transaction *txn) {
-  int64_t key;
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-    KeyType index_key;
-    index_key.SetFromInteger(key);
-    Remove(index_key, txn);
+  std::string line;
+  while (std::getline(input, line)) {
+    const char *p = line.data();
+    const char *end = p + line.size();
+    while (p < end) {
+      while (p < end && std::isspace(*p)) p++;
+      int64_t key;
+      auto res = std::from_chars(p, end, key);
+      if (res.ec != std::errc()) break;
+      p = res.ptr;
+      KeyType index_key;
+      index_key.SetFromInteger(key);
+      Remove(index_key, txn);
+    }
   }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Print(BufferPoolManager *bpm) {
-  auto root_page_id = GetRootPageId();
-  auto guard = bpm->FetchPageBasic(root_page_id);
-  PrintTree(guard.PageId(), guard.template As<BPlusTreePage>());
-}
+void BPLUSTREE_TYPE::Print(BufferPoolManager *bpm) { PrintTree(GetRootPageId()); }
 
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::PrintTree(page_id_t page_id, const BPlusTreePage *page) {
-  if (page->IsLeafPage()) {
-    auto *leaf = reinterpret_cast<const LeafPage *>(page);
-    std::cout << "Leaf Page: " << page_id << "\tNext: " << leaf->GetNextPageId() << std::endl;
-
-    // Print the contents of the leaf page.
-    std::cout << "Contents: ";
-    for (int i = 0; i < leaf->GetSize(); i++) {
-      std::cout << leaf->KeyAt(i);
-      if ((i + 1) < leaf->GetSize()) {
-        std::cout << ", ";
+void BPLUSTREE_TYPE::PrintTree(page_id_t page_id) {
+  // Level-order traversal: all siblings are printed (and fetched) before any
+  // grandchild, so the buffer pool's working set stays at one tree level at a
+  // time, and the background prefetcher runs a whole level ahead of the
+  // formatting instead of one page ahead.
+  //
+  // Formatting goes through a local stringstream and reaches stdout as one
+  // write per page: operator<< on cout pays a sentry and locale check per
+  // fragment and std::endl forced a flush per line, which dominated printing
+  // large trees.
+  std::deque<page_id_t> que = {page_id};
+  std::ostringstream buf;
+  while (!que.empty()) {
+    auto pid = que.front();
+    que.pop_front();
+    auto guard = bpm_->FetchPageBasic(pid);
+    auto page = guard.template As<BPlusTreePage>();
+    buf.str("");
+    if (page->IsLeafPage()) {
+      auto *leaf = guard.template As<LeafPage>();
+      buf << "Leaf Page: " << pid << "\tNext: " << leaf->GetNextPageId() << '\n';
+
+      // Print the contents of the leaf page.
+      buf << "Contents: ";
+      for (int i = 0; i < leaf->GetSize(); i++) {
+        buf << leaf->KeyAt(i);
+        if ((i + 1) < leaf->GetSize()) {
+          buf << ", ";
+        }
       }
-    }
-    std::cout << std::endl;
-    std::cout << std::endl;
+      buf << "\n\n";
+    } else {
+      auto *internal = guard.template As<InternalPage>();
+      buf << "Internal Page: " << pid << '\n';
 
-  } else {
-    auto *internal = reinterpret_cast<const InternalPage *>(page);
-    std::cout << "Internal Page: " << page_id << std::endl;
-
-    // Print the contents of the internal page.
-    std::cout << "Contents: ";
-    for (int i = 0; i < internal->GetSize(); i++) {
-      std::cout << internal->KeyAt(i) << ": " << internal->ValueAt(i);
-      if ((i + 1) < internal->GetSize()) {
-        std::cout << ", ";
+      // Print the contents of the internal page.
+      buf << "Contents: ";
+      for (int i = 0; i < internal->GetSize(); i++) {
+        buf << internal->KeyAt(i) << ": " << internal->ValueAt(i);
+        if ((i + 1) < internal->GetSize()) {
+          buf << ", ";
+        }
+      }
+      buf << "\n\n";
+      for (int i = 0; i < internal->GetSize(); i++) {
+        bpm_->PrefetchPage(internal->ValueAt(i));
+      }
+      for (int i = 0; i < internal->GetSize(); i++) {
+        que.push_back(internal->ValueAt(i));
       }
     }
-    std::cout << std::endl;
-    std::cout << std::endl;
-    for (int i = 0; i < internal->GetSize(); i++) {
-      auto guard = bpm_->FetchPageBasic(internal->ValueAt(i));
-      PrintTree(guard.PageId(), guard.template As<BPlusTreePage>());
-    }
+    auto str = buf.str();
+    std::cout.write(str.data(), str.size());
   }
+  std::cout.flush();
 }
 
 /**
@@ -434,11 +855,9 @@ void BPLUSTREE_TYPE::Draw(BufferPoolManager *bpm, const std::string &outf) {
   }
 
   std::ofstream out(outf);
-  out << "digraph G {" << std::endl;
-  auto root_page_id = GetRootPageId();
-  auto guard = bpm->FetchPageBasic(root_page_id);
-  ToGraph(guard.PageId(), guard.template As<BPlusTreePage>(), out);
-  out << "}" << std::endl;
+  out << "digraph G {\n";
+  ToGraph(GetRootPageId(), out);
+  out << "}\n";
   out.close();
 }
 
@@ -446,81 +865,101 @@ void BPLUSTREE_TYPE::Draw(BufferPoolManager *bpm, const std::string &outf) {
  * This method is used for debug only, You don't need to modify
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::ToGraph(page_id_t page_id, const BPlusTreePage *page, std::ofstream &out) {
+void BPLUSTREE_TYPE::ToGraph(page_id_t page_id, std::ofstream &out) {
   std::string leaf_prefix("LEAF_");
   std::string internal_prefix("INT_");
-  if (page->IsLeafPage()) {
-    auto *leaf = reinterpret_cast<const LeafPage *>(page);
-    // Print node name
-    out << leaf_prefix << page_id;
-    // Print node properties
-    out << "[shape=plain color=green ";
-    // Print data of the node
-    out << "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n";
-    // Print data
-    out << "<TR><TD COLSPAN=\"" << leaf->GetSize() << "\">P=" << page_id << "</TD></TR>\n";
-    out << "<TR><TD COLSPAN=\"" << leaf->GetSize() << "\">"
-        << "max_size=" << leaf->GetMaxSize() << ",min_size=" << leaf->GetMinSize() << ",size=" << leaf->GetSize()
-        << "</TD></TR>\n";
-    out << "<TR>";
-    for (int i = 0; i < leaf->GetSize(); i++) {
-      out << "<TD>" << leaf->KeyAt(i) << "</TD>\n";
+  // Level-order traversal, like PrintTree. Each queue entry remembers its
+  // parent and left sibling so the parent edge and the sibling rank=same
+  // constraint can be emitted when the child itself is visited — the only
+  // point where the child's node type (and hence its dot name) is known.
+  // All children of one node are the same kind, so an internal page's left
+  // sibling is always internal too.
+  struct Visit {
+    page_id_t pid_;
+    page_id_t parent_;
+    page_id_t left_sibling_;
+  };
+  std::deque<Visit> que = {{page_id, INVALID_PAGE_ID, INVALID_PAGE_ID}};
+  // Assemble the whole graph in memory and hand the file stream one write at
+  // the end; per-fragment operator<< on the ofstream was the bottleneck on
+  // large trees.
+  std::ostringstream graph;
+  while (!que.empty()) {
+    auto visit = que.front();
+    que.pop_front();
+    auto guard = bpm_->FetchPageBasic(visit.pid_);
+    auto page = guard.template As<BPlusTreePage>();
+    auto &prefix = page->IsLeafPage() ? leaf_prefix : internal_prefix;
+    if (visit.parent_ != INVALID_PAGE_ID) {
+      graph << internal_prefix << visit.parent_ << ":p" << visit.pid_ << " -> " << prefix << visit.pid_ << ";\n";
     }
-    out << "</TR>";
-    // Print table end
-    out << "</TABLE>>];\n";
-    // Print Leaf node link if there is a next page
-    if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
-      out << leaf_prefix << page_id << " -> " << leaf_prefix << leaf->GetNextPageId() << ";\n";
-      out << "{rank=same " << leaf_prefix << page_id << " " << leaf_prefix << leaf->GetNextPageId() << "};\n";
-    }
-  } else {
-    auto *inner = reinterpret_cast<const InternalPage *>(page);
-    // Print node name
-    out << internal_prefix << page_id;
-    // Print node properties
-    out << "[shape=plain color=pink ";  // why not?
-    // Print data of the node
-    out << "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n";
-    // Print data
-    out << "<TR><TD COLSPAN=\"" << inner->GetSize() << "\">P=" << page_id << "</TD></TR>\n";
-    out << "<TR><TD COLSPAN=\"" << inner->GetSize() << "\">"
-        << "max_size=" << inner->GetMaxSize() << ",min_size=" << inner->GetMinSize() << ",size=" << inner->GetSize()
-        << "</TD></TR>\n";
-    out << "<TR>";
-    for (int i = 0; i < inner->GetSize(); i++) {
-      out << "<TD PORT=\"p" << inner->ValueAt(i) << "\">";
-      if (i > 0) {
-        out << inner->KeyAt(i);
-      } else {
-        out << " ";
+    if (page->IsLeafPage()) {
+      auto *leaf = guard.template As<LeafPage>();
+      // Print node name
+      graph << leaf_prefix << visit.pid_;
+      // Print node properties
+      graph << "[shape=plain color=green ";
+      // Print data of the node
+      graph << "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n";
+      // Print data
+      graph << "<TR><TD COLSPAN=\"" << leaf->GetSize() << "\">P=" << visit.pid_ << "</TD></TR>\n";
+      graph << "<TR><TD COLSPAN=\"" << leaf->GetSize() << "\">"
+          << "max_size=" << leaf->GetMaxSize() << ",min_size=" << leaf->GetMinSize() << ",size=" << leaf->GetSize()
+          << "</TD></TR>\n";
+      graph << "<TR>";
+      for (int i = 0; i < leaf->GetSize(); i++) {
+        graph << "<TD>" << leaf->KeyAt(i) << "</TD>\n";
       }
-      out << "</TD>\n";
-    }
-    out << "</TR>";
-    // Print table end
-    out << "</TABLE>>];\n";
-    // Print leaves
-    for (int i = 0; i < inner->GetSize(); i++) {
-      auto child_guard = bpm_->FetchPageBasic(inner->ValueAt(i));
-      auto child_page = child_guard.template As<BPlusTreePage>();
-      ToGraph(child_guard.PageId(), child_page, out);
-      if (i > 0) {
-        auto sibling_guard = bpm_->FetchPageBasic(inner->ValueAt(i - 1));
-        auto sibling_page = sibling_guard.template As<BPlusTreePage>();
-        if (!sibling_page->IsLeafPage() && !child_page->IsLeafPage()) {
-          out << "{rank=same " << internal_prefix << sibling_guard.PageId() << " " << internal_prefix
-              << child_guard.PageId() << "};\n";
+      graph << "</TR>";
+      // Print table end
+      graph << "</TABLE>>];\n";
+      // Print Leaf node link if there is a next page
+      if (leaf->GetNextPageId() != INVALID_PAGE_ID) {
+        graph << leaf_prefix << visit.pid_ << " -> " << leaf_prefix << leaf->GetNextPageId() << ";\n";
+        graph << "{rank=same " << leaf_prefix << visit.pid_ << " " << leaf_prefix << leaf->GetNextPageId() << "};\n";
+      }
+    } else {
+      auto *inner = guard.template As<InternalPage>();
+      if (visit.left_sibling_ != INVALID_PAGE_ID) {
+        graph << "{rank=same " << internal_prefix << visit.left_sibling_ << " " << internal_prefix << visit.pid_
+            << "};\n";
+      }
+      // Print node name
+      graph << internal_prefix << visit.pid_;
+      // Print node properties
+      graph << "[shape=plain color=pink ";  // why not?
+      // Print data of the node
+      graph << "label=<<TABLE BORDER=\"0\" CELLBORDER=\"1\" CELLSPACING=\"0\" CELLPADDING=\"4\">\n";
+      // Print data
+      graph << "<TR><TD COLSPAN=\"" << inner->GetSize() << "\">P=" << visit.pid_ << "</TD></TR>\n";
+      graph << "<TR><TD COLSPAN=\"" << inner->GetSize() << "\">"
+          << "max_size=" << inner->GetMaxSize() << ",min_size=" << inner->GetMinSize() << ",size=" << inner->GetSize()
+          << "</TD></TR>\n";
+      graph << "<TR>";
+      for (int i = 0; i < inner->GetSize(); i++) {
+        graph << "<TD PORT=\"p" << inner->ValueAt(i) << "\">";
+        if (i > 0) {
+          graph << inner->KeyAt(i);
+        } else {
+          graph << " ";
         }
+        graph << "</TD>\n";
       }
-      out << internal_prefix << page_id << ":p" << child_guard.PageId() << " -> ";
-      if (child_page->IsLeafPage()) {
-        out << leaf_prefix << child_guard.PageId() << ";\n";
-      } else {
-        out << internal_prefix << child_guard.PageId() << ";\n";
+      graph << "</TR>";
+      // Print table end
+      graph << "</TABLE>>];\n";
+      // Queue the children with the background prefetcher first, as PrintTree
+      // does, so a whole level's reads overlap with the formatting.
+      for (int i = 0; i < inner->GetSize(); i++) {
+        bpm_->PrefetchPage(inner->ValueAt(i));
+      }
+      for (int i = 0; i < inner->GetSize(); i++) {
+        que.push_back({inner->ValueAt(i), visit.pid_, i > 0 ? inner->ValueAt(i - 1) : INVALID_PAGE_ID});
       }
     }
   }
+  auto str = graph.str();
+  out.write(str.data(), str.size());
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -538,30 +977,48 @@ auto BPLUSTREE_TYPE::DrawBPlusTree() -> std::string {
 
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::ToPrintableBPlusTree(page_id_t root_id) -> PrintableBPlusTree {
-  auto root_page_guard = bpm_->FetchPageBasic(root_id);
-  auto root_page = root_page_guard.template As<BPlusTreePage>();
-  PrintableBPlusTree proot;
-
-  if (root_page->IsLeafPage()) {
-    auto leaf_page = root_page_guard.template As<LeafPage>();
-    proot.keys_ = leaf_page->ToString();
-    proot.size_ = proot.keys_.size() + 4;  // 4 more spaces for indent
-
-    return proot;
+  // Flatten the tree level by level, remembering where each node's children
+  // will land in BFS order, then assemble sizes and child vectors in one
+  // reverse pass. Keeps the buffer-pool access pattern level-ordered and the
+  // stack depth constant, unlike the old depth-first recursion.
+  std::vector<PrintableBPlusTree> nodes;
+  std::vector<std::pair<size_t, size_t>> child_range;  // (first BFS index, count)
+  std::deque<page_id_t> que = {root_id};
+  while (!que.empty()) {
+    auto pid = que.front();
+    que.pop_front();
+    auto guard = bpm_->FetchPageBasic(pid);
+    auto page = guard.template As<BPlusTreePage>();
+    PrintableBPlusTree node;
+    if (page->IsLeafPage()) {
+      auto leaf_page = guard.template As<LeafPage>();
+      node.keys_ = leaf_page->ToString();
+      node.size_ = node.keys_.size() + 4;  // 4 more spaces for indent
+      child_range.emplace_back(0, 0);
+    } else {
+      auto internal_page = guard.template As<InternalPage>();
+      node.keys_ = internal_page->ToString();
+      node.size_ = 0;
+      // The pages already queued become the next que.size() nodes; this
+      // node's children follow immediately after them.
+      child_range.emplace_back(nodes.size() + que.size() + 1, internal_page->GetSize());
+      for (int i = 0; i < internal_page->GetSize(); i++) {
+        bpm_->PrefetchPage(internal_page->ValueAt(i));
+      }
+      for (int i = 0; i < internal_page->GetSize(); i++) {
+        que.push_back(internal_page->ValueAt(i));
+      }
+    }
+    nodes.push_back(std::move(node));
   }
-
-  // draw internal page
-  auto internal_page = root_page_guard.template As<InternalPage>();
-  proot.keys_ = internal_page->ToString();
-  proot.size_ = 0;
-  for (int i = 0; i < internal_page->GetSize(); i++) {
-    page_id_t child_id = internal_page->ValueAt(i);
-    PrintableBPlusTree child_node = ToPrintableBPlusTree(child_id);
-    proot.size_ += child_node.size_;
-    proot.children_.push_back(child_node);
+  for (auto i = nodes.size(); i-- > 0;) {
+    auto first = child_range[i].first;
+    for (size_t j = 0; j < child_range[i].second; j++) {
+      nodes[i].size_ += nodes[first + j].size_;
+      nodes[i].children_.push_back(std::move(nodes[first + j]));
+    }
   }
-
-  return proot;
+  return nodes[0];
 }
 
 template class BPlusTree<GenericKey<4>, RID, GenericComparator<4>>;
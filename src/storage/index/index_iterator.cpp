@@ -8,6 +8,13 @@
 
 namespace bustub {
 
+/*
+ * The descent crabs read latches down to the target leaf and leaves the leaf
+ * latched AND pinned: the iterator holds both for as long as it sits on the
+ * page, so IsEnd, dereference and increment read the leaf without any
+ * per-call latch traffic. Parents are unpinned as soon as their child is
+ * latched.
+ */
 #define ITERATOR_CONSTRUCTOR(cond) ReadPageGuard rg = bpm_->FetchPageRead(header_page_id); \
                                     auto root_page = rg.As<BPlusTreeHeaderPage>(); \
                                     auto pid = root_page->root_page_id_; \
@@ -22,13 +29,10 @@ namespace bustub {
                                         Page *child = bpm_->FetchPage(pid); \
                                         child->RLatch(); \
                                         page_->RUnlatch(); \
+                                        bpm_->UnpinPage(page_->GetPageId(), false); \
                                         page_ = child; \
                                     } \
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(page_id_t header_page_id, BufferPoolManager *bpm) : bpm_(bpm) {
     ITERATOR_CONSTRUCTOR(internal_page->ValueAt(0))
@@ -37,23 +41,49 @@ INDEXITERATOR_TYPE::IndexIterator(page_id_t header_page_id, BufferPoolManager *b
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(page_id_t header_page_id, BufferPoolManager *bpm, const KeyType &key, const KeyComparator &comparator) : bpm_(bpm) {
     ITERATOR_CONSTRUCTOR(internal_page->Lookup(key, comparator).first)
-    page_->RLatch();
+    // The macro already leaves the leaf read-latched; latching it a second
+    // time here (as this constructor used to) self-deadlocks as soon as a
+    // writer is queued between the two acquisitions.
     auto leaf_page = reinterpret_cast<const LeafPage *>(page_->GetData());
     i_ = leaf_page->IndexOfFirstKeyEqualOrGreaterThan(key, comparator).first;
-    page_->RUnlatch();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
+void INDEXITERATOR_TYPE::Release() {
+    if (page_) {
+        page_->RUnlatch();
+        bpm_->UnpinPage(page_->GetPageId(), false);
+        page_ = nullptr;
+    }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : bpm_(other.bpm_), page_(other.page_), i_(other.i_) {
+    other.page_ = nullptr;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept -> INDEXITERATOR_TYPE & {
+    if (this != &other) {
+        Release();
+        bpm_ = other.bpm_;
+        page_ = other.page_;
+        i_ = other.i_;
+        other.page_ = nullptr;
+    }
+    return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }  // NOLINT
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::IsEnd() -> bool {
     bool isEnd = true;
     if (page_) {
-        page_->RLatch();
         auto leaf_page = reinterpret_cast<const LeafPage *>(page_->GetData());
         if (i_ < leaf_page->GetSize() || leaf_page->GetNextPageId() != INVALID_PAGE_ID) isEnd = false;
-        page_->RUnlatch();
     }
     return isEnd;
 }
@@ -66,26 +96,39 @@ auto INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const -> bool { re
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
-    page_->RLatch();
+    // The leaf stores keys and values in separate arrays, so materialize the
+    // pair into the iterator and hand out a reference to that. The leaf is
+    // kept read-latched for the iterator's lifetime, so no latch is needed.
     auto leaf_page = reinterpret_cast<const LeafPage *>(page_->GetData());
-    const MappingType& res = leaf_page->At(i_);
-    page_->RUnlatch();
-    return res;
+    cur_ = std::make_pair(leaf_page->KeyAt(i_), leaf_page->ValueAt(i_));
+    return cur_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
-    auto cur = page_;
-    cur->RLatch();
     auto leaf_page = reinterpret_cast<const LeafPage *>(page_->GetData());
     if (i_ < leaf_page->GetSize() - 1) {
         i_++;
-    } else {
-        auto pid = leaf_page->GetNextPageId();
-        i_ = 0;
-        page_ = pid == INVALID_PAGE_ID ? nullptr : bpm_->FetchPage(pid);
+        // Hand the successor leaf to the background readahead a few entries
+        // before the page turn, so its disk read overlaps with consuming the
+        // tail of this leaf. Resident pages make it a cheap no-op, and the
+        // within-leaf scan itself is linear enough for the hardware
+        // prefetcher. Triggered exactly once per leaf.
+        if (leaf_page->GetSize() - i_ == 8) {
+            bpm_->PrefetchPage(leaf_page->GetNextPageId());
+        }
+        return *this;
+    }
+    // Page turn: release the current leaf before latching its successor, so
+    // the iterator never holds two leaf latches (the same order the previous
+    // per-call latching produced).
+    auto pid = leaf_page->GetNextPageId();
+    Release();
+    i_ = 0;
+    if (pid != INVALID_PAGE_ID) {
+        page_ = bpm_->FetchPage(pid);
+        page_->RLatch();
     }
-    cur->RUnlatch();
     return *this;
 }
 
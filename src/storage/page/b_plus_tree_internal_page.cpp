@@ -9,8 +9,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstring>
 #include <iostream>
 #include <sstream>
+#include <type_traits>
 
 #include "common/exception.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -19,6 +21,7 @@ namespace bustub {
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
+  ZeroVersion();
   SetSize(0);
   SetMaxSize(max_size);
   SetPageType(IndexPageType::INTERNAL_PAGE);
@@ -27,118 +30,158 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size) {
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(int max_size, const ValueType &lhs, const KeyType &mid, const ValueType &rhs) {
   Init(max_size);
-  array_[0].second = lhs;
-  array_[1] = std::make_pair(mid, rhs);
+  values_[0] = lhs;
+  keys_[1] = mid;
+  values_[1] = rhs;
   SetSize(2);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
-  return array_[index].first;
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> const KeyType & {
+  return keys_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  array_[index].first = key;
+  BumpVersion();
+  keys_[index] = key;
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType {
-  return array_[index].second;
+  return values_[index];
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetValueAt(int index, const ValueType &value) {
+  BumpVersion();
+  values_[index] = value;
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const -> std::pair<ValueType, int> {
-  auto n = GetSize();
-  auto i = 1, j = n - 1;
-  while (i <= j) {
-    auto mid = i + (j - i) / 2;
-    auto res = comparator(key, array_[mid].first);
-    if (res < 0) {
-      j = mid - 1;
-    } else if (res > 0) {
-      i = mid + 1;
-    } else {
-      return std::make_pair(array_[mid].second, mid);
-    }
+  // Branchless binary search for the last separator <= key. The interval update
+  // compiles to a conditional move, so the branch predictor never sees the
+  // (data-dependent) comparison outcome, and prefetching both possible next
+  // midpoints hides the cache miss of the following iteration. This captures
+  // the wins of a BFS/Eytzinger key layout without giving up the sorted order
+  // that splits, merges and the iterator rely on.
+  auto base = 1, len = GetSize() - 1;
+  while (len > 1) {
+    auto half = len / 2;
+    __builtin_prefetch(&keys_[base + half / 2]);
+    __builtin_prefetch(&keys_[base + half + half / 2]);
+    base += comparator(key, keys_[base + half - 1]) >= 0 ? half : 0;
+    len -= half;
   }
-  return std::make_pair(array_[j].second, j);
+  auto i = len > 0 && comparator(key, keys_[base]) >= 0 ? base : base - 1;
+  return std::make_pair(values_[i], i);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *dst) {
+  BumpVersion();
   auto n = GetSize();
-  dst->CopyNFrom(n, array_);
+  dst->CopyNFrom(n, keys_, values_);
   IncreaseSize(-n);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *dst) {
+  BumpVersion();
   auto n = GetSize() / 2;
-  dst->CopyNFrom(n, &array_[GetSize()-n]);
+  dst->CopyNFrom(n, &keys_[GetSize()-n], &values_[GetSize()-n]);
   IncreaseSize(-n);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveBackToFrontOf(void *data) {
+  BumpVersion();
   auto dst = static_cast<BPlusTreeInternalPage *>(data);
   auto n = GetSize();
   BUSTUB_ASSERT(n > 0, "Can't move an empty internal node.");
-  dst->CopyToFront(&array_[n-1]);
+  dst->CopyToFront(keys_[n-1], values_[n-1]);
   IncreaseSize(-1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFrontToBackOf(void *data) {
+  BumpVersion();
   auto dst = static_cast<BPlusTreeInternalPage *>(data);
   auto n = GetSize();
   BUSTUB_ASSERT(n > 0, "Can't move an empty internal node.");
-  dst->CopyToBack(array_);
-  for (auto i = 1; i < n; i++) array_[i-1] = std::move(array_[i]);
+  dst->CopyToBack(keys_[0], values_[0]);
+  std::memmove(&keys_[0], &keys_[1], (n - 1) * sizeof(KeyType));
+  std::memmove(&values_[0], &values_[1], (n - 1) * sizeof(ValueType));
   IncreaseSize(-1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(const KeyType &key, const ValueType &val, int i) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Can't insert to a full leaf.");
   BUSTUB_ASSERT(i >= 0 && i <= GetSize(), "Can only insert at index 0 to n, where n is the current size of the leaf.");
-  for (auto j = n - 1; j >= i; j--) array_[j+1] = std::move(array_[j]);
-  array_[i] = std::make_pair(key, val);
+  std::memmove(&keys_[i + 1], &keys_[i], (n - i) * sizeof(KeyType));
+  std::memmove(&values_[i + 1], &values_[i], (n - i) * sizeof(ValueType));
+  keys_[i] = key;
+  values_[i] = val;
   IncreaseSize(1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(int n, MappingType *data) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(int n, const KeyType *keys, const ValueType *values) {
+  BumpVersion();
+  static_assert(std::is_trivially_copyable<KeyType>::value && std::is_trivially_copyable<ValueType>::value,
+                "Raw byte moves require trivially copyable key/value types.");
   auto n_cur = GetSize(), n_max = GetMaxSize();
   BUSTUB_ASSERT(n_cur + n <= n_max, "Not enough space to copy.");
-  for (auto i = n_cur; i < n_cur + n; i++) array_[i] = std::move(data[i-n_cur]);
+  std::memcpy(&keys_[n_cur], keys, n * sizeof(KeyType));
+  std::memcpy(&values_[n_cur], values, n * sizeof(ValueType));
   IncreaseSize(n);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyToFront(MappingType *data) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyToFront(const KeyType &key, const ValueType &value) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Not enough space to copy.");
-  for (auto i = n - 1; i >= 0; i--) array_[i+1] = std::move(array_[i]);
-  array_[0] = std::move(*data);
+  std::memmove(&keys_[1], &keys_[0], n * sizeof(KeyType));
+  std::memmove(&values_[1], &values_[0], n * sizeof(ValueType));
+  keys_[0] = key;
+  values_[0] = value;
   IncreaseSize(1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyToBack(MappingType *data) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyToBack(const KeyType &key, const ValueType &value) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Not enough space to copy.");
-  array_[n] = std::move(*data);
+  keys_[n] = key;
+  values_[n] = value;
   IncreaseSize(1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int i) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(i >= 0 && i < n, "Remove out of range.");
-  for (auto j = i; j < n - 1; j++) array_[j] = std::move(array_[j+1]);
+  std::memmove(&keys_[i], &keys_[i + 1], (n - 1 - i) * sizeof(KeyType));
+  std::memmove(&values_[i], &values_[i + 1], (n - 1 - i) * sizeof(ValueType));
   IncreaseSize(-1);
+  BumpVersion();
 }
 
 // valuetype for internalNode should be page id_t
@@ -9,7 +9,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <type_traits>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/rid.h"
@@ -17,48 +21,59 @@
 
 namespace bustub {
 
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(int max_size) {
-  SetSize(0);
-  SetMaxSize(max_size);
-  SetPageType(IndexPageType::LEAF_PAGE);
-  SetNextPageId(INVALID_PAGE_ID);
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
-
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+// Init, GetNextPageId and SetNextPageId live on BPlusTreeLeafPageBase in the
+// header: they don't depend on the template arguments, so one inline copy
+// replaces five instantiated ones.
 
 INDEX_TEMPLATE_ARGUMENTS
-KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> const KeyType & {
   BUSTUB_ASSERT(index >= 0 && index < GetSize(), "index out of range.");
-  return array_[index].first;
+  return keys_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType& B_PLUS_TREE_LEAF_PAGE_TYPE::At(int index) const {
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
   BUSTUB_ASSERT(index >= 0 && index < GetSize(), "index out of range.");
-  return array_[index];
+  return values_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::IndexOfFirstKeyEqualOrGreaterThan(const KeyType &key, const KeyComparator &comparator) const -> std::pair<int, bool> {
+  // Branchless lower bound, same shape as InternalPage::Lookup: the interval
+  // update compiles to a conditional move, so random keys cost no branch
+  // mispredictions, and prefetching both candidate midpoints hides the next
+  // iteration's cache miss. The early-exit of the old three-way search only
+  // helped on exact hits at the midpoint, which are rare for large leaves.
   auto n = GetSize();
-  int i = 0, j = n - 1;
-  while (i <= j) {
-    int mid = i + (j - i) / 2;
-    auto res = comparator(key, array_[mid].first);
-    if (res < 0) {
-      j = mid - 1;
-    } else if (res > 0) {
-      i = mid + 1;
-    } else {
-      return std::make_pair(mid, true);
-    }
+  // Tiny leaves: a forward scan beats the halving loop — the exit branch is
+  // the only one and it predicts, the accesses are sequential, and the whole
+  // range fits in the lines the first midpoint probe would pull anyway.
+  if (n <= 8) {
+    int i = 0;
+    while (i < n && comparator(keys_[i], key) < 0) i++;
+    return std::make_pair(i, i < n && comparator(keys_[i], key) == 0);
   }
-  return std::make_pair(i, false);
+  // Boundary early-out: probes that miss the page entirely — sibling scans
+  // and monotonic insert probes landing on the wrong leaf — are answered by
+  // the fence keys alone, skipping the whole halving loop. In-range keys pay
+  // two extra compares against keys the loop's first iterations would load
+  // anyway.
+  auto cmin = comparator(key, keys_[0]);
+  if (cmin <= 0) return std::make_pair(0, cmin == 0);
+  auto cmax = comparator(key, keys_[n - 1]);
+  if (cmax > 0) return std::make_pair(n, false);
+  if (cmax == 0) return std::make_pair(n - 1, true);
+  // key > keys_[0] and key < keys_[n-1]: the lower bound lies in [1, n-1).
+  int base = 1, len = n - 1;
+  while (len > 1) {
+    auto half = len / 2;
+    __builtin_prefetch(&keys_[base + half / 2]);
+    __builtin_prefetch(&keys_[base + half + half / 2]);
+    base += comparator(keys_[base + half - 1], key) < 0 ? half : 0;
+    len -= half;
+  }
+  auto i = len > 0 && comparator(keys_[base], key) < 0 ? base + 1 : base;
+  return std::make_pair(i, i < n && comparator(keys_[i], key) == 0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -66,12 +81,47 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *val, cons
   if (!GetSize()) return false;
   auto res = IndexOfFirstKeyEqualOrGreaterThan(key, comparator);
   if (res.second) {
-    *val = array_[res.first].second;
+    *val = values_[res.first];
     return true;
   }
   return false;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::LookupBatch(const KeyType *keys, int nkeys, ValueType *out, bool *found,
+                                             const KeyComparator &comparator) const {
+  auto n = GetSize();
+  // Below the crossover where k binary searches stop beating one n + k merge
+  // walk, just probe individually.
+  if (nkeys < 8 || n == 0) {
+    for (int i = 0; i < nkeys; i++) {
+      found[i] = Lookup(keys[i], &out[i], comparator);
+    }
+    return;
+  }
+  // Sort an index permutation instead of the (possibly wide) keys themselves,
+  // then walk both sorted sequences in lockstep. Equal query keys repeat
+  // against the same leaf slot, so duplicates in the batch come out right.
+  std::vector<int> order(nkeys);
+  for (int i = 0; i < nkeys; i++) order[i] = i;
+  std::sort(order.begin(), order.end(),
+            [&](int a, int b) { return comparator(keys[a], keys[b]) < 0; });
+  for (int i = 0; i < nkeys; i++) found[order[i]] = false;
+  int j = 0;
+  for (int i = 0; i < nkeys && j < n; ) {
+    auto c = comparator(keys[order[i]], keys_[j]);
+    if (c < 0) {
+      i++;
+    } else if (c > 0) {
+      j++;
+    } else {
+      out[order[i]] = values_[j];
+      found[order[i]] = true;
+      i++;
+    }
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &val, const KeyComparator &comparator) -> bool {
   auto n = GetSize(), i = 0;
@@ -80,87 +130,112 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &val
     if (res.second) return false;
     i = res.first;
   }
-  BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Can't insert to a full leaf.");
-  for (auto j = n - 1; j >= i; j--) array_[j+1] = std::move(array_[j]);
-  array_[i] = std::make_pair(key, val);
-  IncreaseSize(1);
+  InsertAt(key, val, i);
   return true;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(const KeyType &key, const ValueType &val, int i) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Can't insert to a full leaf.");
   BUSTUB_ASSERT(i >= 0 && i <= GetSize(), "Can only insert at index 0 to n, where n is the current size of the leaf.");
-  for (auto j = n - 1; j >= i; j--) array_[j+1] = std::move(array_[j]);
-  array_[i] = std::make_pair(key, val);
+  std::memmove(&keys_[i + 1], &keys_[i], (n - i) * sizeof(KeyType));
+  std::memmove(&values_[i + 1], &values_[i], (n - i) * sizeof(ValueType));
+  keys_[i] = key;
+  values_[i] = val;
   IncreaseSize(1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Remove(int i) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(i < n, "i is out of range.");
-  for (auto j = i; j < n - 1; j++) array_[j] = std::move(array_[j+1]);
+  std::memmove(&keys_[i], &keys_[i + 1], (n - 1 - i) * sizeof(KeyType));
+  std::memmove(&values_[i], &values_[i + 1], (n - 1 - i) * sizeof(ValueType));
   IncreaseSize(-1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *dst) {
+  BumpVersion();
   auto n = GetSize();
-  dst->CopyNFrom(n, array_);
+  dst->CopyNFrom(n, keys_, values_);
   IncreaseSize(-n);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *dst) {
+  BumpVersion();
   auto n = GetSize() / 2;
-  dst->CopyNFrom(n, &array_[GetSize()-n]);
+  dst->CopyNFrom(n, &keys_[GetSize()-n], &values_[GetSize()-n]);
   IncreaseSize(-n);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveBackToFrontOf(void *data) {
+  BumpVersion();
   auto dst = static_cast<BPlusTreeLeafPage *>(data);
   auto n = GetSize();
   BUSTUB_ASSERT(n > 0, "Can't move an empty internal node.");
-  dst->CopyToFront(&array_[n-1]);
+  dst->CopyToFront(keys_[n-1], values_[n-1]);
   IncreaseSize(-1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFrontToBackOf(void *data) {
+  BumpVersion();
   auto dst = static_cast<BPlusTreeLeafPage *>(data);
   auto n = GetSize();
   BUSTUB_ASSERT(n > 0, "Can't move an empty internal node.");
-  dst->CopyToBack(array_);
-  for (auto i = 1; i < n; i++) array_[i-1] = std::move(array_[i]);
+  dst->CopyToBack(keys_[0], values_[0]);
+  std::memmove(&keys_[0], &keys_[1], (n - 1) * sizeof(KeyType));
+  std::memmove(&values_[0], &values_[1], (n - 1) * sizeof(ValueType));
   IncreaseSize(-1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(int n, MappingType *data) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(int n, const KeyType *keys, const ValueType *values) {
+  BumpVersion();
+  static_assert(std::is_trivially_copyable<KeyType>::value && std::is_trivially_copyable<ValueType>::value,
+                "Raw byte moves require trivially copyable key/value types.");
   auto n_cur = GetSize(), n_max = GetMaxSize();
   BUSTUB_ASSERT(n_cur + n <= n_max, "Not enough space to copy.");
-  for (auto i = n_cur; i < n_cur + n; i++) array_[i] = std::move(data[i-n_cur]);
+  std::memcpy(&keys_[n_cur], keys, n * sizeof(KeyType));
+  std::memcpy(&values_[n_cur], values, n * sizeof(ValueType));
   IncreaseSize(n);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyToFront(MappingType *data) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyToFront(const KeyType &key, const ValueType &value) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Not enough space to copy.");
-  for (auto i = n - 1; i >= 0; i--) array_[i+1] = std::move(array_[i]);
-  array_[0] = std::move(*data);
+  std::memmove(&keys_[1], &keys_[0], n * sizeof(KeyType));
+  std::memmove(&values_[1], &values_[0], n * sizeof(ValueType));
+  keys_[0] = key;
+  values_[0] = value;
   IncreaseSize(1);
+  BumpVersion();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyToBack(MappingType *data) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyToBack(const KeyType &key, const ValueType &value) {
+  BumpVersion();
   auto n = GetSize();
   BUSTUB_ASSERT(n + 1 <= GetMaxSize(), "Not enough space to copy.");
-  array_[n] = std::move(*data);
+  keys_[n] = key;
+  values_[n] = value;
   IncreaseSize(1);
+  BumpVersion();
 }
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
@@ -11,35 +11,5 @@
 
 #include "storage/page/b_plus_tree_page.h"
 
-namespace bustub {
-
-/*
- * Helper methods to get/set page type
- * Page type enum class is defined in b_plus_tree_page.h
- */
-auto BPlusTreePage::IsLeafPage() const -> bool { return page_type_ == IndexPageType::LEAF_PAGE; }
-void BPlusTreePage::SetPageType(IndexPageType page_type) { page_type_ = page_type; }
-
-/*
- * Helper methods to get/set size (number of key/value pairs stored in that
- * page)
- */
-auto BPlusTreePage::GetSize() const -> int { return size_; }
-void BPlusTreePage::SetSize(int size) { size_ = size; }
-void BPlusTreePage::IncreaseSize(int amount) { size_ += amount; }
-
-/*
- * Helper methods to get/set max size (capacity) of the page
- */
-auto BPlusTreePage::GetMaxSize() const -> int { return max_size_; }
-void BPlusTreePage::SetMaxSize(int size) { max_size_ = size; }
-
-/*
- * Helper method to get min page size
- * Generally, min page size == max page size / 2
- */
-auto BPlusTreePage::GetMinSize() const -> int { return (max_size_+1)/2; }
-
-auto BPlusTreePage::CanBorrow() const -> bool { return GetSize() > GetMinSize(); }
-
-}  // namespace bustub
+// All accessors live in the header so they inline into the per-level checks
+// of the tree descent; nothing is left to define here.
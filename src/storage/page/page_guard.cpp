@@ -6,8 +6,13 @@ namespace bustub {
 BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept {
     bpm_ = that.bpm_;
     page_ = that.page_;
+    // The dirty flag travels with ownership: a guard that was AsMut()'d and
+    // then moved must still unpin its page dirty, or the frame can be evicted
+    // without writeback.
+    is_dirty_ = that.is_dirty_;
     that.bpm_ = nullptr;
     that.page_ = nullptr;
+    that.is_dirty_ = false;
 }
 
 void BasicPageGuard::Drop() {
@@ -15,6 +20,7 @@ void BasicPageGuard::Drop() {
         bpm_->UnpinPage(page_->GetPageId(), is_dirty_);
         bpm_ = nullptr;
         page_ = nullptr;
+        is_dirty_ = false;
     }
 }
 
@@ -22,8 +28,10 @@ auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard
     Drop();
     bpm_ = that.bpm_;
     page_ = that.page_;
+    is_dirty_ = that.is_dirty_;
     that.bpm_ = nullptr;
     that.page_ = nullptr;
+    that.is_dirty_ = false;
     return *this;
 }
 
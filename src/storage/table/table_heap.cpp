@@ -36,14 +36,11 @@ TableHeap::TableHeap(BufferPoolManager *bpm) : bpm_(bpm) {
   first_page->Init();
 }
 
-auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
-                            table_oid_t oid) -> std::optional<RID> {
-  std::unique_lock<std::mutex> guard(latch_);
-  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
+void TableHeap::EnsureSpaceLocked(const TupleMeta &meta, const Tuple &tuple, WritePageGuard &page_guard) {
   while (true) {
     auto page = page_guard.AsMut<TablePage>();
     if (page->GetNextTupleOffset(meta, tuple) != std::nullopt) {
-      break;
+      return;
     }
 
     // if there's no tuple in the page, and we can't insert the tuple, then this tuple is too large.
@@ -67,6 +64,13 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
     last_page_id_ = next_page_id;
     page_guard = std::move(next_page_guard);
   }
+}
+
+auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManager *lock_mgr, Transaction *txn,
+                            table_oid_t oid) -> std::optional<RID> {
+  std::unique_lock<std::mutex> guard(latch_);
+  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
+  EnsureSpaceLocked(meta, tuple, page_guard);
   auto last_page_id = last_page_id_;
 
   auto page = page_guard.AsMut<TablePage>();
@@ -85,14 +89,44 @@ auto TableHeap::InsertTuple(const TupleMeta &meta, const Tuple &tuple, LockManag
   return RID(last_page_id, slot_id);
 }
 
+auto TableHeap::InsertTuples(const TupleMeta &meta, const std::vector<Tuple> &tuples, LockManager *lock_mgr,
+                             Transaction *txn, table_oid_t oid) -> std::vector<RID> {
+  std::vector<RID> rids;
+  rids.reserve(tuples.size());
+  if (tuples.empty()) {
+    return rids;
+  }
+  // One latch acquisition and one page-guard chain for the whole batch: consecutive
+  // tuples land on the same write-latched page until it fills up.
+  std::unique_lock<std::mutex> guard(latch_);
+  auto page_guard = bpm_->FetchPageWrite(last_page_id_);
+  for (const auto &tuple : tuples) {
+    EnsureSpaceLocked(meta, tuple, page_guard);
+    auto page = page_guard.AsMut<TablePage>();
+    rids.emplace_back(last_page_id_, *page->InsertTuple(meta, tuple));
+  }
+  guard.unlock();
+  page_guard.Drop();
+
+  // Row locks are taken after the latch is released, same as the single-tuple path.
+  if (lock_mgr != nullptr) {
+    for (const auto &rid : rids) {
+      BUSTUB_ENSURE(lock_mgr->LockRow(txn, LockManager::LockMode::EXCLUSIVE, oid, rid),
+                    "failed to lock when inserting new tuple");
+    }
+  }
+
+  return rids;
+}
+
 void TableHeap::UpdateTupleMeta(const TupleMeta &meta, RID rid) {
   auto page_guard = bpm_->FetchPageWrite(rid.GetPageId());
   auto page = page_guard.AsMut<TablePage>();
   page->UpdateTupleMeta(meta, rid);
 }
 
-auto TableHeap::GetTuple(RID rid) -> std::pair<TupleMeta, Tuple> {
-  auto page_guard = bpm_->FetchPageRead(rid.GetPageId());
+auto TableHeap::GetTuple(RID rid, AccessType access_type) -> std::pair<TupleMeta, Tuple> {
+  auto page_guard = bpm_->FetchPageRead(rid.GetPageId(), access_type);
   auto page = page_guard.As<TablePage>();
   auto [meta, tuple] = page->GetTuple(rid);
   tuple.rid_ = rid;
@@ -105,14 +139,14 @@ auto TableHeap::GetTupleMeta(RID rid) -> TupleMeta {
   return page->GetTupleMeta(rid);
 }
 
-auto TableHeap::MakeIterator() -> TableIterator {
+auto TableHeap::MakeIterator(AccessType access_type) -> TableIterator {
   std::unique_lock<std::mutex> guard(latch_);
   auto last_page_id = last_page_id_;
   guard.unlock();
 
-  auto page_guard = bpm_->FetchPageRead(last_page_id);
+  auto page_guard = bpm_->FetchPageRead(last_page_id, access_type);
   auto page = page_guard.As<TablePage>();
-  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}};
+  return {this, {first_page_id_, 0}, {last_page_id, page->GetNumTuples()}, access_type};
 }
 
 auto TableHeap::MakeEagerIterator() -> TableIterator { return {this, {first_page_id_, 0}, {INVALID_PAGE_ID, 0}}; }
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, BasicTest) {
+  PageTable table;
+
+  EXPECT_EQ(table.Find(0), nullptr);
+
+  table.Insert(0, 10);
+  table.Insert(1, 11);
+  ASSERT_NE(table.Find(0), nullptr);
+  EXPECT_EQ(*table.Find(0), 10);
+  ASSERT_NE(table.Find(1), nullptr);
+  EXPECT_EQ(*table.Find(1), 11);
+  EXPECT_EQ(table.Find(2), nullptr);
+
+  // Insert overwrites an existing mapping in place.
+  table.Insert(0, 20);
+  EXPECT_EQ(*table.Find(0), 20);
+
+  table.Erase(0);
+  EXPECT_EQ(table.Find(0), nullptr);
+  // Erasing an absent key is a no-op.
+  table.Erase(0);
+  EXPECT_EQ(*table.Find(1), 11);
+
+  // A tombstoned slot must not break the probe run for keys behind it.
+  table.Insert(0, 30);
+  EXPECT_EQ(*table.Find(0), 30);
+  EXPECT_EQ(*table.Find(1), 11);
+}
+
+// Sequential page ids are the common case; drive the table through several
+// growths and a round of erases and make sure every surviving mapping is
+// still reachable.
+TEST(PageTableTest, GrowAndChurnTest) {
+  PageTable table;
+  constexpr page_id_t n = 10000;
+
+  for (page_id_t pid = 0; pid < n; pid++) {
+    table.Insert(pid, static_cast<frame_id_t>(pid + 1));
+  }
+  for (page_id_t pid = 0; pid < n; pid++) {
+    ASSERT_NE(table.Find(pid), nullptr);
+    EXPECT_EQ(*table.Find(pid), pid + 1);
+  }
+
+  for (page_id_t pid = 0; pid < n; pid += 2) {
+    table.Erase(pid);
+  }
+  for (page_id_t pid = 0; pid < n; pid++) {
+    if (pid % 2 == 0) {
+      EXPECT_EQ(table.Find(pid), nullptr);
+    } else {
+      ASSERT_NE(table.Find(pid), nullptr);
+      EXPECT_EQ(*table.Find(pid), pid + 1);
+    }
+  }
+
+  // Re-inserting into tombstoned runs must reuse the dead slots without
+  // losing the keys probing past them.
+  for (page_id_t pid = 0; pid < n; pid += 2) {
+    table.Insert(pid, static_cast<frame_id_t>(pid + 2));
+  }
+  for (page_id_t pid = 0; pid < n; pid++) {
+    ASSERT_NE(table.Find(pid), nullptr);
+    EXPECT_EQ(*table.Find(pid), pid % 2 == 0 ? pid + 2 : pid + 1);
+  }
+}
+
+TEST(FreeFrameQueueTest, BasicTest) {
+  FreeFrameQueue queue(4);
+  frame_id_t fid;
+
+  EXPECT_FALSE(queue.Pop(&fid));
+
+  for (frame_id_t i = 0; i < 4; i++) {
+    EXPECT_TRUE(queue.Push(i));
+  }
+  // Capacity 4 rounds to itself; a fifth push must report full.
+  EXPECT_FALSE(queue.Push(4));
+
+  // FIFO order.
+  for (frame_id_t i = 0; i < 4; i++) {
+    EXPECT_TRUE(queue.Pop(&fid));
+    EXPECT_EQ(fid, i);
+  }
+  EXPECT_FALSE(queue.Pop(&fid));
+}
+
+// Every frame id pushed by the producers must come out exactly once across
+// the consumers — a frame handed to two threads is how pages get corrupted.
+TEST(FreeFrameQueueTest, ConcurrentTest) {
+  constexpr int num_threads = 4;
+  constexpr int per_thread = 10000;
+  FreeFrameQueue queue(num_threads * per_thread);
+  std::vector<std::atomic<int>> seen(num_threads * per_thread);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < per_thread; i++) {
+        ASSERT_TRUE(queue.Push(t * per_thread + i));
+      }
+    });
+  }
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&] {
+      frame_id_t fid;
+      for (int i = 0; i < per_thread;) {
+        if (queue.Pop(&fid)) {
+          seen[fid]++;
+          i++;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  frame_id_t fid;
+  EXPECT_FALSE(queue.Pop(&fid));
+  for (auto &count : seen) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+}  // namespace bustub
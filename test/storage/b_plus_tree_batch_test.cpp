@@ -0,0 +1,141 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_batch_test.cpp
+//
+// Identification: test/storage/b_plus_tree_batch_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using bustub::DiskManagerUnlimitedMemory;
+
+// GetValueBatch must agree with GetValue for every key, hits and misses
+// alike. The 10-frame pool makes the insert phase evict and re-read every
+// level of the tree, so this doubles as the small-pool insert regression the
+// 50-frame suites never exercise.
+TEST(BPlusTreeTests, GetValueBatchTest1) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(10, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  ASSERT_EQ(page_id, HEADER_PAGE_ID);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 2, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  // Only the even keys are present; the odd ones probe the misses.
+  std::vector<int64_t> keys;
+  for (int64_t i = 2; i <= 2000; i += 2) keys.push_back(i);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(42));  // NOLINT
+  for (auto key : keys) {
+    int64_t value = key & 0xFFFFFFFF;
+    rid.Set(static_cast<int32_t>(key >> 32), value);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  std::vector<GenericKey<8>> batch;
+  for (int64_t key = 1; key <= 2000; key++) {
+    index_key.SetFromInteger(key);
+    batch.push_back(index_key);
+  }
+  std::shuffle(batch.begin(), batch.end(), std::mt19937(7));  // NOLINT
+
+  std::vector<std::vector<RID>> batch_result;
+  tree.GetValueBatch(batch, &batch_result, transaction);
+  ASSERT_EQ(batch_result.size(), batch.size());
+
+  std::vector<RID> rids;
+  for (size_t i = 0; i < batch.size(); i++) {
+    rids.clear();
+    bool is_present = tree.GetValue(batch[i], &rids);
+    EXPECT_EQ(batch_result[i].size(), rids.size());
+    if (is_present) {
+      ASSERT_EQ(batch_result[i].size(), 1);
+      EXPECT_EQ(batch_result[i][0], rids[0]);
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+
+// Duplicate keys in one batch, a batch against an empty tree, and an empty
+// batch are the edge shapes the merge walk has to get right.
+TEST(BPlusTreeTests, GetValueBatchTest2) {
+  // create KeyComparator and index schema
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  auto disk_manager = std::make_unique<DiskManagerUnlimitedMemory>();
+  auto *bpm = new BufferPoolManager(10, disk_manager.get());
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", header_page->GetPageId(), bpm, comparator, 2, 3);
+  GenericKey<8> index_key;
+  RID rid;
+  // create transaction
+  auto *transaction = new Transaction(0);
+
+  std::vector<std::vector<RID>> batch_result;
+  std::vector<GenericKey<8>> batch;
+
+  // Empty batch and empty tree.
+  tree.GetValueBatch(batch, &batch_result, transaction);
+  EXPECT_EQ(batch_result.size(), 0);
+  index_key.SetFromInteger(1);
+  batch.assign(16, index_key);
+  tree.GetValueBatch(batch, &batch_result, transaction);
+  ASSERT_EQ(batch_result.size(), batch.size());
+  for (auto &result : batch_result) {
+    EXPECT_EQ(result.size(), 0);
+  }
+
+  for (int64_t key = 1; key <= 50; key++) {
+    int64_t value = key & 0xFFFFFFFF;
+    rid.Set(static_cast<int32_t>(key >> 32), value);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // The same present key repeated must answer every slot.
+  index_key.SetFromInteger(25);
+  batch.assign(16, index_key);
+  tree.GetValueBatch(batch, &batch_result, transaction);
+  ASSERT_EQ(batch_result.size(), batch.size());
+  for (auto &result : batch_result) {
+    ASSERT_EQ(result.size(), 1);
+    EXPECT_EQ(result[0].GetSlotNum(), 25);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+}
+}  // namespace bustub